@@ -0,0 +1,87 @@
+#ifndef GUARD_BENCH_BENCHMARK_HPP__
+#define GUARD_BENCH_BENCHMARK_HPP__
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Minimal benchmark harness. A benchmark is a function registered with
+// BENCHMARK(name), which times its cases with best_of and prints one line per
+// case with report. The benchmarks executable runs every benchmark, or only
+// the ones whose name contains its first argument.
+namespace bench {
+typedef void (*Function)();
+
+inline std::vector<std::pair<const char *, Function>> &registry() {
+  static std::vector<std::pair<const char *, Function>> benchmarks;
+  return benchmarks;
+}
+
+inline bool add(const char *name, Function f) {
+  registry().emplace_back(name, f);
+  return true;
+}
+
+// Results are written here so that the compiler cannot remove the
+// computations that produce them
+inline volatile std::size_t sink;
+inline void consume(std::size_t value) { sink = sink + value; }
+
+// Run f, which performs the given number of operations, several times and
+// return the best time per operation in nanoseconds
+template <class F>
+double best_of(std::size_t operations, F f, int repetitions = 5) {
+  double best = 0;
+  for (int r = 0; r < repetitions; ++r) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+    double ns = elapsed.count() / static_cast<double>(operations);
+    if (r == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+inline void report(const std::string &name, double value,
+                   const char *unit = "ns/op") {
+  std::printf("  %-52s %10.2f %s\n", name.c_str(), value, unit);
+}
+
+// Thread counts of the scaling benchmarks: powers of 2 up to the number of
+// hardware threads, and at least up to 4 to show the cost of contention
+inline std::vector<unsigned> thread_counts() {
+  unsigned max = std::max(4u, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts;
+  for (unsigned t = 1; t < max; t *= 2)
+    counts.push_back(t);
+  counts.push_back(max);
+  return counts;
+}
+
+// Deterministic pseudo random numbers (splitmix64)
+struct Random {
+  std::uint64_t state;
+  explicit Random(std::uint64_t seed = 42) : state(seed) {}
+  std::uint64_t operator()() {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+};
+} // namespace bench
+
+#define BENCHMARK(name)                                                        \
+  static void bench_##name();                                                  \
+  static const bool bench_registered_##name = bench::add(#name, bench_##name); \
+  static void bench_##name()
+
+#endif // GUARD_BENCH_BENCHMARK_HPP__
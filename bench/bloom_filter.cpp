@@ -0,0 +1,47 @@
+#include "benchmark.hpp"
+#include "hash_table.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+constexpr std::size_t lookup_count = 1000000;
+
+// Lookups in a table of the even numbers below 2 * size, of which the given
+// percentage hits
+std::vector<std::size_t> lookups(std::size_t size, unsigned hit_percent) {
+  bench::Random random;
+  std::vector<std::size_t> keys(lookup_count);
+  for (auto &k : keys)
+    k = (random() % size) * 2 + (random() % 100 < hit_percent ? 0 : 1);
+  return keys;
+}
+
+double contains_ns(std::size_t size, std::size_t bits_per_key,
+                   const std::vector<std::size_t> &keys) {
+  HashTable<std::size_t> table;
+  table.bloom_filter(bits_per_key);
+  for (std::size_t k = 0; k < size * 2; k += 2)
+    table.insert(k);
+  return bench::best_of(keys.size(), [&] {
+    std::size_t found = 0;
+    for (std::size_t k : keys)
+      found += table.contains(k);
+    bench::consume(found);
+  });
+}
+} // namespace
+
+// HashTable::contains with and without the Bloom filter, for a table that
+// fits in the cache and one that does not, at several hit rates
+BENCHMARK(bloom_filter) {
+  for (std::size_t size : {std::size_t(1) << 14, std::size_t(1) << 21}) {
+    for (unsigned hits : {0, 10, 50, 90, 100}) {
+      auto keys = lookups(size, hits);
+      std::string suffix = " (" + std::to_string(size) + " elements, " +
+                           std::to_string(hits) + "% hits)";
+      bench::report("no filter" + suffix, contains_ns(size, 0, keys));
+      bench::report("10 bits per key" + suffix, contains_ns(size, 10, keys));
+    }
+  }
+}
@@ -0,0 +1,90 @@
+#include "benchmark.hpp"
+#include "concurrent_hash_table.hpp"
+#include "hash_table.hpp"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+// The previous way to share a table: a HashTable behind one mutex
+struct LockedHashTable {
+  HashTable<std::size_t> table;
+  mutable std::mutex mutex;
+
+  void insert(std::size_t v) {
+    std::lock_guard<std::mutex> lock(mutex);
+    table.insert(v);
+  }
+  void erase(std::size_t v) {
+    std::lock_guard<std::mutex> lock(mutex);
+    table.erase(v);
+  }
+  bool contains(std::size_t v) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return table.contains(v);
+  }
+};
+
+constexpr std::size_t key_count = 1 << 16;
+constexpr std::size_t operations_per_thread = 200000;
+
+// Every thread runs 80% lookups of any key and 20% insertions or removals of
+// keys it owns, so that the modifications never conflict. Return the number
+// of operations per microsecond over all threads.
+template <class Table> double operations_per_us(unsigned threads) {
+  Table table;
+  for (std::size_t k = 0; k < key_count; k += 2)
+    table.insert(k);
+
+  auto work = [&](unsigned t) {
+    bench::Random random(t + 1);
+    std::vector<bool> present(key_count / threads + 1);
+    for (std::size_t i = 0; i < present.size(); ++i) {
+      std::size_t key = i * threads + t;
+      present[i] = key < key_count && key % 2 == 0;
+    }
+    std::size_t found = 0;
+    for (std::size_t op = 0; op < operations_per_thread; ++op) {
+      std::uint64_t r = random();
+      if (r % 10 < 8) {
+        found += table.contains((r >> 8) % key_count);
+        continue;
+      }
+      std::size_t i = (r >> 8) % present.size();
+      std::size_t key = i * threads + t;
+      if (present[i])
+        table.erase(key);
+      else
+        table.insert(key);
+      present[i] = !present[i];
+    }
+    bench::consume(found);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (unsigned t = 1; t < threads; ++t)
+    workers.emplace_back(work, t);
+  work(0);
+  for (std::thread &w : workers)
+    w.join();
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return static_cast<double>(operations_per_thread * threads) /
+         elapsed.count();
+}
+} // namespace
+
+// Throughput of a mixed workload for an increasing number of threads
+BENCHMARK(concurrent_hash_table) {
+  for (unsigned threads : bench::thread_counts()) {
+    std::string suffix = ", " + std::to_string(threads) + " threads";
+    bench::report("HashTable with a mutex" + suffix,
+                  operations_per_us<LockedHashTable>(threads), "ops/us");
+    bench::report("ConcurrentHashTable" + suffix,
+                  operations_per_us<ConcurrentHashTable<std::size_t>>(threads),
+                  "ops/us");
+  }
+}
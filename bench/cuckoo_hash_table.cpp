@@ -0,0 +1,63 @@
+#include "benchmark.hpp"
+#include "cuckoo_hash_table.hpp"
+#include "hash_table.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+constexpr std::size_t lookup_count = 1000000;
+
+struct Timings {
+  double insert, hit, miss;
+};
+
+// Insert the even numbers below 2 * size, then look up present and absent
+// values in random order
+template <class Table> Timings time_table(std::size_t size) {
+  bench::Random random;
+  std::vector<std::size_t> hits(lookup_count), misses(lookup_count);
+  for (std::size_t i = 0; i < lookup_count; ++i) {
+    hits[i] = (random() % size) * 2;
+    misses[i] = (random() % size) * 2 + 1;
+  }
+
+  Timings t;
+  t.insert = bench::best_of(size, [&] {
+    Table table;
+    for (std::size_t k = 0; k < size * 2; k += 2)
+      table.insert(k);
+    bench::consume(table.size());
+  });
+  Table table;
+  for (std::size_t k = 0; k < size * 2; k += 2)
+    table.insert(k);
+  auto lookups = [&](const std::vector<std::size_t> &keys) {
+    return bench::best_of(keys.size(), [&] {
+      std::size_t found = 0;
+      for (std::size_t k : keys)
+        found += table.contains(k);
+      bench::consume(found);
+    });
+  };
+  t.hit = lookups(hits);
+  t.miss = lookups(misses);
+  return t;
+}
+
+template <class Table> void report(const std::string &name, std::size_t size) {
+  Timings t = time_table<Table>(size);
+  std::string suffix = " (" + std::to_string(size) + " elements)";
+  bench::report(name + " insert" + suffix, t.insert);
+  bench::report(name + " hit" + suffix, t.hit);
+  bench::report(name + " miss" + suffix, t.miss);
+}
+} // namespace
+
+// CuckooHashTable against the chained HashTable
+BENCHMARK(cuckoo_hash_table) {
+  for (std::size_t size : {std::size_t(1) << 14, std::size_t(1) << 21}) {
+    report<HashTable<std::size_t>>("HashTable", size);
+    report<CuckooHashTable<std::size_t>>("CuckooHashTable", size);
+  }
+}
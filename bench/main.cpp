@@ -0,0 +1,15 @@
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+int main(int argc, char **argv) {
+  const char *filter = argc > 1 ? argv[1] : "";
+  for (const auto &b : bench::registry()) {
+    if (std::strstr(b.first, filter) == nullptr)
+      continue;
+    std::printf("%s\n", b.first);
+    b.second();
+  }
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "benchmark.hpp"
+#include "hash_table.hpp"
+#include "read_mostly_hash_table.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+// A HashTable behind a reader-writer lock, the usual way to share a table
+// that is mostly read
+struct SharedLockHashTable {
+  HashTable<std::size_t> table;
+  mutable std::shared_mutex mutex;
+
+  template <class F> void update(F f) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    f(table);
+  }
+  void insert(std::size_t v) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    table.insert(v);
+  }
+  void erase(std::size_t v) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    table.erase(v);
+  }
+  bool contains(std::size_t v) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return table.contains(v);
+  }
+};
+
+constexpr std::size_t key_count = 1 << 16;
+constexpr std::size_t lookups_per_reader = 1000000;
+
+// Lookups per microsecond over all the readers, while one more thread keeps
+// inserting and removing a value
+template <class Table> double lookups_per_us(unsigned readers) {
+  Table table;
+  table.update([](HashTable<std::size_t> &t) {
+    for (std::size_t k = 0; k < key_count; k += 2)
+      t.insert(k);
+  });
+
+  std::atomic<bool> done{false};
+  std::size_t writes = 0;
+  std::thread writer([&] {
+    for (; !done.load(); ++writes) {
+      if (writes % 2 == 0)
+        table.insert(key_count + 1);
+      else
+        table.erase(key_count + 1);
+    }
+  });
+
+  auto read = [&](unsigned r) {
+    bench::Random random(r + 1);
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < lookups_per_reader; ++i)
+      found += table.contains(random() % key_count);
+    bench::consume(found);
+  };
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned r = 1; r < readers; ++r)
+    threads.emplace_back(read, r);
+  read(0);
+  for (std::thread &t : threads)
+    t.join();
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  done.store(true);
+  writer.join();
+  return static_cast<double>(lookups_per_reader * readers) / elapsed.count();
+}
+} // namespace
+
+// Read throughput for an increasing number of readers, with a writer thread
+// modifying the table all along
+BENCHMARK(read_mostly_hash_table) {
+  for (unsigned readers : bench::thread_counts()) {
+    std::string suffix = ", " + std::to_string(readers) + " readers";
+    bench::report("HashTable with a shared_mutex" + suffix,
+                  lookups_per_us<SharedLockHashTable>(readers), "lookups/us");
+    bench::report(
+        "ReadMostlyHashTable" + suffix,
+        lookups_per_us<ReadMostlyHashTable<std::size_t>>(readers),
+        "lookups/us");
+  }
+}
@@ -0,0 +1,72 @@
+#include "benchmark.hpp"
+#include "details/seeded_hash.hpp"
+#include "hash_table.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+std::vector<std::string> random_strings(std::size_t count,
+                                        std::size_t length) {
+  bench::Random random;
+  std::vector<std::string> strings(count);
+  for (auto &s : strings)
+    for (std::size_t i = 0; i < length; ++i)
+      s.push_back(static_cast<char>('a' + random() % 26));
+  return strings;
+}
+
+template <class Hash, class T> double hash_ns(const std::vector<T> &values) {
+  Hash hash;
+  return bench::best_of(values.size(), [&] {
+    std::size_t total = 0;
+    for (const auto &v : values)
+      total += hash(v);
+    bench::consume(total);
+  });
+}
+
+// Fill a table with the values then look each of them up
+template <class Hash, class T>
+double insert_find_ns(const std::vector<T> &values) {
+  return bench::best_of(values.size(), [&] {
+    HashTable<T, Hash> table;
+    for (const auto &v : values)
+      table.insert(v);
+    std::size_t found = 0;
+    for (const auto &v : values)
+      found += table.contains(v);
+    bench::consume(found);
+  });
+}
+} // namespace
+
+// Cost of seeded_hash over the unkeyed hash, alone and in a HashTable
+BENCHMARK(seeded_hash) {
+  bench::Random random;
+  std::vector<std::size_t> integers(200000);
+  for (auto &i : integers)
+    i = random();
+  bench::report("hash<size_t>", hash_ns<hash<std::size_t>>(integers));
+  bench::report("seeded_hash<size_t>",
+                hash_ns<seeded_hash<std::size_t>>(integers));
+
+  for (std::size_t length : {8, 32, 256}) {
+    auto strings = random_strings(100000, length);
+    std::string suffix = " (" + std::to_string(length) + " bytes)";
+    bench::report("hash<std::string>" + suffix,
+                  hash_ns<hash<std::string>>(strings));
+    bench::report("seeded_hash<std::string>" + suffix,
+                  hash_ns<seeded_hash<std::string>>(strings));
+  }
+
+  bench::report("HashTable<size_t> insert and find, hash",
+                insert_find_ns<hash<std::size_t>>(integers));
+  bench::report("HashTable<size_t> insert and find, seeded_hash",
+                insert_find_ns<seeded_hash<std::size_t>>(integers));
+  auto keys = random_strings(200000, 12);
+  bench::report("HashTable<std::string> insert and find, hash",
+                insert_find_ns<hash<std::string>>(keys));
+  bench::report("HashTable<std::string> insert and find, seeded_hash",
+                insert_find_ns<seeded_hash<std::string>>(keys));
+}
@@ -0,0 +1,70 @@
+#include "benchmark.hpp"
+#include "details/hash.hpp"
+#include "hash_table.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+// The string hash used before hash_bytes
+std::size_t djb2(const std::string &t) {
+  std::size_t hash = 5381;
+  for (auto c = t.begin(); c != t.end(); ++c)
+    hash = ((hash << 5) + hash) + *c;
+  return hash;
+}
+
+struct Djb2Hash {
+  std::size_t operator()(const std::string &t) const { return djb2(t); }
+};
+
+std::vector<std::string> random_strings(std::size_t count,
+                                        std::size_t length) {
+  bench::Random random;
+  std::vector<std::string> strings(count);
+  for (auto &s : strings)
+    for (std::size_t i = 0; i < length; ++i)
+      s.push_back(static_cast<char>('a' + random() % 26));
+  return strings;
+}
+
+template <class F>
+double bytes_per_ns(const std::vector<std::string> &strings, F hash) {
+  double ns = bench::best_of(strings.size(), [&] {
+    std::size_t total = 0;
+    for (const auto &s : strings)
+      total += hash(s);
+    bench::consume(total);
+  });
+  return static_cast<double>(strings[0].size()) / ns;
+}
+
+template <class Table> double lookup_ns(const std::vector<std::string> &keys) {
+  Table table;
+  for (const auto &k : keys)
+    table.insert(k);
+  return bench::best_of(keys.size(), [&] {
+    std::size_t found = 0;
+    for (const auto &k : keys)
+      found += table.contains(k);
+    bench::consume(found);
+  });
+}
+} // namespace
+
+// Throughput of hash<std::string> against djb2, and the effect on lookups
+BENCHMARK(string_hash) {
+  for (std::size_t length : {4, 16, 64, 256, 4096}) {
+    auto strings = random_strings(length < 256 ? 100000 : 10000, length);
+    std::string suffix = " (" + std::to_string(length) + " bytes)";
+    bench::report("djb2" + suffix, bytes_per_ns(strings, djb2), "bytes/ns");
+    bench::report("hash<std::string>" + suffix,
+                  bytes_per_ns(strings, hash<std::string>()), "bytes/ns");
+  }
+
+  auto keys = random_strings(200000, 12);
+  bench::report("HashTable<std::string> lookup, djb2",
+                lookup_ns<HashTable<std::string, Djb2Hash>>(keys));
+  bench::report("HashTable<std::string> lookup, hash<std::string>",
+                lookup_ns<HashTable<std::string>>(keys));
+}
@@ -0,0 +1,102 @@
+#include "benchmark.hpp"
+#include "hash_table.hpp"
+
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr std::size_t operation_count = 100000;
+
+// Distinct keys in random order, of which the given percentage is in a table
+// filled with the even numbers below 2 * operation_count
+std::vector<std::size_t> keys_with_duplicates(unsigned percent) {
+  bench::Random random;
+  std::vector<std::size_t> keys(operation_count);
+  for (std::size_t i = 0; i < keys.size(); ++i)
+    keys[i] = i * 2 + (random() % 100 < percent ? 0 : 1);
+  for (std::size_t i = keys.size() - 1; i > 0; --i)
+    std::swap(keys[i], keys[random() % (i + 1)]);
+  return keys;
+}
+
+HashTable<std::size_t> filled_table() {
+  HashTable<std::size_t> table;
+  for (std::size_t k = 0; k < operation_count * 2; k += 2)
+    table.insert(k);
+  return table;
+}
+
+// Insert every key, counting the duplicates. The table is rebuilt before
+// every run, outside of the measured time.
+template <class F>
+double upsert_ns(const std::vector<std::size_t> &keys, F upsert) {
+  double best = 0;
+  for (int r = 0; r < 5; ++r) {
+    HashTable<std::size_t> table = filled_table();
+    double ns = bench::best_of(
+        keys.size(),
+        [&] {
+          std::size_t duplicates = 0;
+          for (std::size_t k : keys)
+            duplicates += upsert(table, k);
+          bench::consume(duplicates);
+        },
+        1);
+    if (r == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+template <class F>
+double lookup_ns(const std::vector<std::size_t> &keys, F lookup) {
+  HashTable<std::size_t> table = filled_table();
+  return bench::best_of(keys.size(), [&] {
+    std::size_t total = 0;
+    for (std::size_t k : keys)
+      total += lookup(table, k);
+    bench::consume(total);
+  });
+}
+} // namespace
+
+// Cost of the exceptions thrown by insert and operator[] on the values that
+// are already in the table or missing, against try_insert and find
+BENCHMARK(try_insert) {
+  for (unsigned percent : {0, 10, 50, 90}) {
+    auto keys = keys_with_duplicates(percent);
+    std::string suffix = " (" + std::to_string(percent) + "% duplicates)";
+    bench::report("insert, catching the duplicates" + suffix,
+                  upsert_ns(keys, [](HashTable<std::size_t> &t, std::size_t k) {
+                    try {
+                      t.insert(k);
+                      return 0;
+                    } catch (const std::runtime_error &) {
+                      return 1;
+                    }
+                  }));
+    bench::report("try_insert" + suffix,
+                  upsert_ns(keys, [](HashTable<std::size_t> &t, std::size_t k) {
+                    return t.try_insert(k).second ? 0 : 1;
+                  }));
+  }
+
+  for (unsigned percent : {10, 50, 90}) {
+    auto keys = keys_with_duplicates(100 - percent);
+    std::string suffix = " (" + std::to_string(percent) + "% misses)";
+    bench::report("operator[], catching the misses" + suffix,
+                  lookup_ns(keys, [](HashTable<std::size_t> &t, std::size_t k) {
+                    try {
+                      return t[k];
+                    } catch (const std::out_of_range &) {
+                      return std::size_t(0);
+                    }
+                  }));
+    bench::report("find" + suffix,
+                  lookup_ns(keys, [](HashTable<std::size_t> &t, std::size_t k) {
+                    auto found = t.find(k);
+                    return found ? *found : 0;
+                  }));
+  }
+}
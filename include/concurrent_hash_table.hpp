@@ -0,0 +1,257 @@
+#ifndef GUARD_CONCURRENT_HASH_TABLE_HPP__
+#define GUARD_CONCURRENT_HASH_TABLE_HPP__
+
+#include "details/hash.hpp"
+#include "single_linked_list.hpp"
+#include <atomic>
+#include <initializer_list>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+// Hash table safe for concurrent use by several threads. The buckets are
+// divided between a fixed number of stripes, each protected by its own mutex:
+// operations on elements of different stripes never wait for each other.
+//
+// The number of buckets is always a multiple of the number of stripes, and a
+// bucket belongs to the stripe given by the low bits of its position. When the
+// table doubles, the elements of a bucket move to buckets of the same stripe,
+// so the table can be resized one stripe at a time. The thread triggering a
+// resize publishes the new bucket array, then every thread inserting or
+// erasing an element helps moving the stripes that have not been migrated yet.
+// Each stripe records which array holds its buckets, so operations on a stripe
+// keep working on the old array until the stripe is migrated.
+template <class Type, class HashFunctor = hash<Type>>
+struct ConcurrentHashTable {
+  // Constructs an empty hash table. The number of stripes bounds the number
+  // of threads that can work on the table in parallel, it is rounded up to a
+  // power of 2
+  explicit ConcurrentHashTable(std::size_t stripes = 64);
+  // Constructs a hash table initialized with the list of parameters
+  ConcurrentHashTable(const std::initializer_list<Type> &);
+  ConcurrentHashTable(const ConcurrentHashTable &) = delete;
+  ConcurrentHashTable &operator=(const ConcurrentHashTable &) = delete;
+
+  ~ConcurrentHashTable();
+
+  // Insert a new value into the table
+  // Throw a std::runtime_error if the value is already in the table
+  void insert(const Type &);
+
+  // Remove the given value from the table
+  void erase(const Type &);
+
+  // Return a copy of the value matching the argument if it is in the table.
+  // A copy is returned rather than a reference, since another thread may
+  // remove the value at any time
+  std::optional<Type> find(const Type &) const;
+
+  // Return true if the value is in the table, false otherwise
+  bool contains(const Type &) const;
+
+  // Number of elements in the table. With concurrent modifications, the value
+  // may be outdated as soon as it is returned
+  std::size_t size() const { return _size.load(std::memory_order_relaxed); }
+
+  // Number of buckets of the most recent bucket array
+  std::size_t bucket_count() const {
+    return _bucket_count.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Buckets {
+    explicit Buckets(std::size_t c)
+        : capacity(c), lists(new SingleLinkedList<Type>[c]) {}
+    ~Buckets() { delete[] lists; }
+
+    std::size_t capacity;
+    SingleLinkedList<Type> *lists;
+  };
+
+  // Aligned on a cache line so that threads locking neighbouring stripes do
+  // not contend for the same line
+  struct alignas(64) Stripe {
+    std::mutex mutex;
+    // Generation of the bucket array holding the buckets of the stripe
+    std::size_t generation = 0;
+  };
+
+  std::size_t _stripe_count;
+  Stripe *_stripes;
+  std::atomic<std::size_t> _size, _bucket_count;
+
+  // The array of generation g is stored at _arrays[g % 2]. During a resize
+  // the arrays of the current and the next generation are both alive.
+  std::atomic<Buckets *> _arrays[2];
+  // Generation of the most recent bucket array
+  std::atomic<std::size_t> _generation;
+  // Next stripe to migrate, _stripe_count or more if no stripe is left
+  std::atomic<std::size_t> _cursor;
+  // Held by the thread driving a resize
+  std::mutex _resize_mutex;
+
+  // Run the function on the bucket of the hash, with the lock of its stripe
+  template <class F> auto _with_bucket(std::size_t mixed, F &&f) const;
+  void _help_resize();
+  void _migrate_stripe(std::size_t);
+  void _grow();
+};
+
+template <class T, class H>
+ConcurrentHashTable<T, H>::ConcurrentHashTable(std::size_t stripes)
+    : _stripe_count(details::next_power_of_2(stripes)),
+      _stripes(new Stripe[_stripe_count]), _size(0),
+      _bucket_count(_stripe_count), _generation(0), _cursor(_stripe_count) {
+  try {
+    _arrays[0].store(new Buckets(_stripe_count));
+  } catch (...) {
+    delete[] _stripes;
+    throw;
+  }
+  _arrays[1].store(nullptr);
+}
+
+template <class T, class H>
+ConcurrentHashTable<T, H>::ConcurrentHashTable(
+    const std::initializer_list<T> &list)
+    : ConcurrentHashTable() {
+  for (const auto &e : list) {
+    insert(e);
+  }
+}
+
+template <class T, class H> ConcurrentHashTable<T, H>::~ConcurrentHashTable() {
+  delete _arrays[0].load();
+  delete _arrays[1].load();
+  delete[] _stripes;
+}
+
+template <class T, class H>
+template <class F>
+auto ConcurrentHashTable<T, H>::_with_bucket(std::size_t mixed, F &&f) const {
+  Stripe &stripe = _stripes[mixed & (_stripe_count - 1)];
+  std::lock_guard<std::mutex> lock(stripe.mutex);
+  // The array of the generation of a stripe cannot be freed while the stripe
+  // is locked: the resize frees it only after migrating every stripe
+  Buckets *buckets =
+      _arrays[stripe.generation % 2].load(std::memory_order_acquire);
+  return f(buckets->lists[mixed & (buckets->capacity - 1)]);
+}
+
+template <class T, class H>
+void ConcurrentHashTable<T, H>::insert(const T &val) {
+  _help_resize();
+
+  std::size_t mixed = details::mix_hash(H()(val));
+  _with_bucket(mixed, [&val](SingleLinkedList<T> &store) {
+    if (store.find(val) != store.end())
+      throw std::runtime_error("HashTable insertion error: an element with "
+                               "the same value exists already");
+    store.push_front(val);
+  });
+
+  if (_size.fetch_add(1, std::memory_order_relaxed) + 1 > bucket_count())
+    _grow();
+}
+
+template <class T, class H>
+void ConcurrentHashTable<T, H>::erase(const T &val) {
+  _help_resize();
+
+  std::size_t mixed = details::mix_hash(H()(val));
+  bool erased = _with_bucket(mixed, [&val](SingleLinkedList<T> &store) {
+    auto it = store.find(val);
+    if (it == store.end())
+      return false;
+    store.erase(it);
+    return true;
+  });
+
+  if (erased)
+    _size.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <class T, class H>
+std::optional<T> ConcurrentHashTable<T, H>::find(const T &val) const {
+  std::size_t mixed = details::mix_hash(H()(val));
+  return _with_bucket(mixed, [&val](SingleLinkedList<T> &store) {
+    auto it = store.find(val);
+    return it == store.end() ? std::optional<T>() : std::optional<T>(*it);
+  });
+}
+
+template <class T, class H>
+bool ConcurrentHashTable<T, H>::contains(const T &val) const {
+  std::size_t mixed = details::mix_hash(H()(val));
+  return _with_bucket(mixed, [&val](SingleLinkedList<T> &store) {
+    return store.find(val) != store.end();
+  });
+}
+
+template <class T, class H> void ConcurrentHashTable<T, H>::_help_resize() {
+  // Claim stripes one by one until none is left. Claiming a stripe of a resize
+  // that is already over does no harm: migrating an up to date stripe does
+  // nothing, and the thread driving a resize checks every stripe anyway.
+  while (_cursor.load(std::memory_order_relaxed) < _stripe_count) {
+    std::size_t stripe = _cursor.fetch_add(1, std::memory_order_relaxed);
+    if (stripe >= _stripe_count)
+      return;
+    _migrate_stripe(stripe);
+  }
+}
+
+template <class T, class H>
+void ConcurrentHashTable<T, H>::_migrate_stripe(std::size_t index) {
+  Stripe &stripe = _stripes[index];
+  std::lock_guard<std::mutex> lock(stripe.mutex);
+
+  std::size_t target = _generation.load(std::memory_order_acquire);
+  if (stripe.generation == target)
+    return;
+
+  Buckets *from =
+      _arrays[stripe.generation % 2].load(std::memory_order_acquire);
+  Buckets *to = _arrays[target % 2].load(std::memory_order_acquire);
+  for (std::size_t i = index; i < from->capacity; i += _stripe_count) {
+    SingleLinkedList<T> &store = from->lists[i];
+    while (store.size() > 0) {
+      std::size_t mixed = details::mix_hash(H()(store.first()));
+      to->lists[mixed & (to->capacity - 1)].push_front(
+          std::move(store.first()));
+      store.pop_front();
+    }
+  }
+  stripe.generation = target;
+}
+
+template <class T, class H> void ConcurrentHashTable<T, H>::_grow() {
+  // If another thread is already resizing, helping is enough
+  std::unique_lock<std::mutex> lock(_resize_mutex, std::try_to_lock);
+  if (!lock.owns_lock())
+    return;
+
+  std::size_t generation = _generation.load(std::memory_order_relaxed);
+  Buckets *old = _arrays[generation % 2].load(std::memory_order_relaxed);
+  if (size() <= old->capacity)
+    return;
+
+  _arrays[(generation + 1) % 2].store(new Buckets(old->capacity * 2),
+                                      std::memory_order_release);
+  _bucket_count.store(old->capacity * 2, std::memory_order_relaxed);
+  _cursor.store(0, std::memory_order_relaxed);
+  _generation.store(generation + 1, std::memory_order_release);
+
+  _help_resize();
+  // Stripes claimed by other threads may still be in migration, and a stale
+  // helper may have claimed a stripe without migrating it. Going through every
+  // stripe waits for the former and completes the latter.
+  for (std::size_t i = 0; i < _stripe_count; ++i)
+    _migrate_stripe(i);
+
+  // No stripe refers to the old array anymore
+  _arrays[generation % 2].store(nullptr, std::memory_order_release);
+  delete old;
+}
+
+#endif // GUARD_CONCURRENT_HASH_TABLE_HPP__
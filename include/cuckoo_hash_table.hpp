@@ -0,0 +1,332 @@
+#ifndef GUARD_CUCKOO_HASH_TABLE_HPP__
+#define GUARD_CUCKOO_HASH_TABLE_HPP__
+
+#include "details/hash.hpp"
+#include "details/maybe.hpp"
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Open addressing hash table using bucketized cuckoo hashing: every value has
+// two candidate buckets of 4 slots, derived from two different mixes of its
+// hash, and is always stored in one of them. A lookup checks at most 8 slots
+// whatever the collisions, which bounds its worst case.
+//
+// Each slot keeps a one byte tag taken from the hash of its value, so most
+// slots are skipped without comparing values. When both buckets of a new
+// value are full, the value takes the slot of an element of one of them,
+// which moves to its other bucket, possibly evicting another element, and so
+// on. After a bounded number of evictions the table grows instead.
+template <class Type, class HashFunctor = hash<Type>>
+struct CuckooHashTable {
+  // Constructs an empty hash table
+  CuckooHashTable();
+  // Constructs a hash table initialized with the list of parameters
+  CuckooHashTable(const std::initializer_list<Type> &);
+  CuckooHashTable(const CuckooHashTable &);
+  CuckooHashTable(CuckooHashTable &&);
+
+  ~CuckooHashTable();
+
+  // Insert a new value into the table
+  // Throw a std::runtime_error if the value is already in the table, or if
+  // more values than two buckets can hold have the same hash
+  void insert(const Type &);
+  void insert(Type &&);
+
+  // Remove the given value from the table
+  void erase(const Type &);
+
+  // Return the value matching the argument.
+  // Throw a std::out_of_range if the value is not in the table
+  Type operator[](const Type &) const;
+  Type &operator[](const Type &);
+
+  std::size_t size() const { return _size; }
+
+  // Return the number of buckets of 4 slots in the table
+  std::size_t bucket_count() const { return _bucket_count; }
+
+  // Structure that may contain a value or not
+  template <class T> using Maybe = details::Maybe<T>;
+
+  // Returns a dereferenceable structure that may contain the searched value
+  // Implicitely convertible to bool with true value if the searched value is
+  // contained, false value if the value is not contained
+  Maybe<const Type> find(const Type &) const;
+  Maybe<Type> find(const Type &);
+
+  // Return true if the value is in the table, false otherwise
+  bool contains(const Type &) const;
+
+private:
+  static constexpr std::size_t _slots_per_bucket = 4;
+
+  // A slot is empty when its tag is 0
+  struct Bucket {
+    std::uint8_t tags[_slots_per_bucket] = {};
+    std::aligned_storage_t<sizeof(Type), alignof(Type)>
+        storage[_slots_per_bucket];
+
+    Type &value(std::size_t i) {
+      return *reinterpret_cast<Type *>(&storage[i]);
+    }
+  };
+
+  // The two buckets of a value and its tag
+  struct Location {
+    std::size_t first, second;
+    std::uint8_t tag;
+  };
+
+  std::size_t _size, _bucket_count;
+  Bucket *_buckets;
+
+  // Bucket count is always a power of 2 so that positions can be computed with
+  // a mask. The table grows when it gets 7/8 full, or when an insertion does
+  // not find a free slot after _max_kicks evictions.
+  static constexpr std::size_t _initial_bucket_count = 2;
+  static constexpr std::size_t _max_kicks = 256;
+  bool _needs_resize() const {
+    return (_size + 1) * 8 > _bucket_count * _slots_per_bucket * 7;
+  }
+
+  Location _locate(const Type &val) const {
+    std::uint64_t h = HashFunctor()(val);
+    std::size_t first = details::mix_hash(h);
+    std::uint64_t second = details::multiply_mix(h, 0x9e3779b97f4a7c15ull);
+    // The tag comes from the high bits, which do not select the first bucket
+    std::uint8_t tag = static_cast<std::uint8_t>(
+        first >> (std::numeric_limits<std::size_t>::digits - 8));
+    return {first & (_bucket_count - 1), second & (_bucket_count - 1),
+            static_cast<std::uint8_t>(tag ? tag : 1)};
+  }
+
+  void _insert(Type);
+  void _resize();
+  // Return the value, or nullptr if it is not in the table
+  Type *_find(const Type &);
+  // Store the value in a free slot of one of its buckets, evicting other
+  // elements if needed. Return false if no slot is found after _max_kicks
+  // evictions, the evictions are then undone and the value is left unchanged.
+  bool _place(Type &);
+  static void _destroy(Bucket *, std::size_t);
+};
+
+template <class T, class H>
+CuckooHashTable<T, H>::CuckooHashTable()
+    : _size(0), _bucket_count(_initial_bucket_count),
+      _buckets(new Bucket[_initial_bucket_count]) {}
+
+template <class T, class H>
+CuckooHashTable<T, H>::CuckooHashTable(const std::initializer_list<T> &list)
+    : CuckooHashTable() {
+  for (const auto &e : list) {
+    insert(e);
+  }
+}
+
+template <class T, class H>
+CuckooHashTable<T, H>::CuckooHashTable(const CuckooHashTable<T, H> &h)
+    : _size(0), _bucket_count(h._bucket_count),
+      _buckets(new Bucket[_bucket_count]) {
+  // The slot of a value only depends on its hash, the layout can be copied
+  // slot by slot
+  try {
+    for (std::size_t b = 0; b < _bucket_count; ++b) {
+      for (std::size_t i = 0; i < _slots_per_bucket; ++i) {
+        if (h._buckets[b].tags[i]) {
+          ::new (&_buckets[b].storage[i]) T(h._buckets[b].value(i));
+          _buckets[b].tags[i] = h._buckets[b].tags[i];
+          ++_size;
+        }
+      }
+    }
+  } catch (...) {
+    _destroy(_buckets, _bucket_count);
+    throw;
+  }
+}
+
+template <class T, class H>
+CuckooHashTable<T, H>::CuckooHashTable(CuckooHashTable<T, H> &&h)
+    : CuckooHashTable() {
+  // The buckets left to h are allocated before anything is taken from h, so
+  // that h still owns its elements if the allocation throws
+  std::swap(_size, h._size);
+  std::swap(_bucket_count, h._bucket_count);
+  std::swap(_buckets, h._buckets);
+}
+
+template <class T, class H> CuckooHashTable<T, H>::~CuckooHashTable() {
+  _destroy(_buckets, _bucket_count);
+}
+
+template <class T, class H> void CuckooHashTable<T, H>::insert(const T &val) {
+  if (contains(val))
+    throw std::runtime_error("HashTable insertion error: an element with the "
+                             "same value exists already");
+  _insert(val);
+}
+
+template <class T, class H> void CuckooHashTable<T, H>::insert(T &&val) {
+  if (contains(val))
+    throw std::runtime_error("HashTable insertion error: an element with the "
+                             "same value exists already");
+  _insert(std::move(val));
+}
+
+template <class T, class H> void CuckooHashTable<T, H>::_insert(T val) {
+  if (_needs_resize())
+    _resize();
+  while (!_place(val)) {
+    // A sparse table only fails when too many values share the same buckets,
+    // which no amount of growth can solve
+    if ((_size + 1) * 8 < _bucket_count * _slots_per_bucket)
+      throw std::runtime_error("CuckooHashTable insertion error: too many "
+                               "values have the same hash");
+    _resize();
+  }
+  ++_size;
+}
+
+template <class T, class H> void CuckooHashTable<T, H>::erase(const T &val) {
+  Location l = _locate(val);
+  for (std::size_t b : {l.first, l.second}) {
+    Bucket &bucket = _buckets[b];
+    for (std::size_t i = 0; i < _slots_per_bucket; ++i) {
+      if (bucket.tags[i] == l.tag && bucket.value(i) == val) {
+        bucket.value(i).~T();
+        bucket.tags[i] = 0;
+        --_size;
+        return;
+      }
+    }
+  }
+}
+
+template <class T, class H>
+typename CuckooHashTable<T, H>::template Maybe<const T>
+CuckooHashTable<T, H>::find(const T &value) const {
+  return const_cast<CuckooHashTable<T, H> *>(this)->find(value);
+}
+
+template <class T, class H>
+typename CuckooHashTable<T, H>::template Maybe<T>
+CuckooHashTable<T, H>::find(const T &value) {
+  return Maybe<T>(_find(value));
+}
+
+template <class T, class H>
+T CuckooHashTable<T, H>::operator[](const T &val) const {
+  return const_cast<CuckooHashTable<T, H> *>(this)->operator[](val);
+}
+
+template <class T, class H>
+T &CuckooHashTable<T, H>::operator[](const T &value) {
+  auto maybe = find(value);
+  if (!maybe)
+    throw std::out_of_range(
+        "HashTable::operator[] : the given key is not in the table");
+  return *maybe;
+}
+
+template <class T, class H>
+bool CuckooHashTable<T, H>::contains(const T &value) const {
+  return find(value);
+}
+
+template <class T, class H> T *CuckooHashTable<T, H>::_find(const T &val) {
+  Location l = _locate(val);
+  for (std::size_t b : {l.first, l.second}) {
+    Bucket &bucket = _buckets[b];
+    for (std::size_t i = 0; i < _slots_per_bucket; ++i)
+      if (bucket.tags[i] == l.tag && bucket.value(i) == val)
+        return &bucket.value(i);
+  }
+  return nullptr;
+}
+
+template <class T, class H> bool CuckooHashTable<T, H>::_place(T &value) {
+  // Slots taken by the evictions, with their former tags
+  struct Eviction {
+    Bucket *bucket;
+    std::size_t slot;
+    std::uint8_t tag;
+  } evictions[_max_kicks];
+
+  // Bucket the current value was evicted from, which it must not go back to
+  std::size_t from = _bucket_count;
+  for (std::size_t kick = 0;; ++kick) {
+    Location l = _locate(value);
+    for (std::size_t b : {l.first, l.second}) {
+      Bucket &bucket = _buckets[b];
+      for (std::size_t i = 0; i < _slots_per_bucket; ++i) {
+        if (bucket.tags[i] == 0) {
+          ::new (&bucket.storage[i]) T(std::move(value));
+          bucket.tags[i] = l.tag;
+          return true;
+        }
+      }
+    }
+    if (kick == _max_kicks)
+      break;
+
+    // Both buckets are full: take a slot of the bucket the value did not come
+    // from. The slot varies with the tag and the number of evictions so that
+    // the evictions do not cycle over the same elements.
+    std::size_t b = l.first == from ? l.second : l.first;
+    std::size_t i = (l.tag + kick) % _slots_per_bucket;
+    Bucket &bucket = _buckets[b];
+    evictions[kick] = {&bucket, i, bucket.tags[i]};
+    using std::swap;
+    swap(value, bucket.value(i));
+    bucket.tags[i] = l.tag;
+    from = b;
+  }
+
+  // Undo the evictions in reverse order, which brings back the value
+  for (std::size_t kick = _max_kicks; kick-- > 0;) {
+    using std::swap;
+    swap(value, evictions[kick].bucket->value(evictions[kick].slot));
+    evictions[kick].bucket->tags[evictions[kick].slot] = evictions[kick].tag;
+  }
+  return false;
+}
+
+template <class T, class H> void CuckooHashTable<T, H>::_resize() {
+  std::size_t old_count = _bucket_count;
+  Bucket *old_buckets = _buckets;
+
+  _buckets = new Bucket[_bucket_count * 2];
+  _bucket_count *= 2;
+
+  // Values are known to be unique, they can be placed without comparison. A
+  // value that does not fit in the new array grows it again.
+  for (std::size_t b = 0; b < old_count; ++b) {
+    for (std::size_t i = 0; i < _slots_per_bucket; ++i) {
+      if (old_buckets[b].tags[i]) {
+        T value(std::move(old_buckets[b].value(i)));
+        while (!_place(value))
+          _resize();
+      }
+    }
+  }
+
+  _destroy(old_buckets, old_count);
+}
+
+template <class T, class H>
+void CuckooHashTable<T, H>::_destroy(Bucket *buckets, std::size_t count) {
+  for (std::size_t b = 0; b < count; ++b)
+    for (std::size_t i = 0; i < _slots_per_bucket; ++i)
+      if (buckets[b].tags[i])
+        buckets[b].value(i).~T();
+  delete[] buckets;
+}
+
+#endif // GUARD_CUCKOO_HASH_TABLE_HPP__
@@ -0,0 +1,104 @@
+#ifndef GUARD_DETAILS_BLOOM_FILTER_HPP__
+#define GUARD_DETAILS_BLOOM_FILTER_HPP__
+
+#include "hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+namespace details {
+// Blocked Bloom filter over hashes: a set that may answer that it contains a
+// hash it was never given (a false positive), but never the opposite. Every
+// hash sets its bits in a single block of the size of a cache line, so a query
+// costs at most one cache miss.
+struct BloomFilter {
+  BloomFilter() : _blocks(nullptr), _block_count(0), _hashes(0) {}
+  BloomFilter(const BloomFilter &);
+  BloomFilter(BloomFilter &&f) noexcept
+      : _blocks(std::exchange(f._blocks, nullptr)),
+        _block_count(std::exchange(f._block_count, 0)),
+        _hashes(f._hashes) {}
+  BloomFilter &operator=(BloomFilter f) noexcept {
+    std::swap(_blocks, f._blocks);
+    std::swap(_block_count, f._block_count);
+    std::swap(_hashes, f._hashes);
+    return *this;
+  }
+
+  ~BloomFilter() { delete[] _blocks; }
+
+  // Empty the filter and size it for the given number of keys with the given
+  // number of bits per key. 0 bits disables the filter.
+  void reset(std::size_t keys, std::size_t bits_per_key);
+
+  // True if the filter is in use
+  explicit operator bool() const { return _blocks != nullptr; }
+
+  void insert(std::size_t h) {
+    Probe p = _probe(h);
+    for (unsigned i = 0; i < _hashes; ++i, p.bit += p.step)
+      p.block->words[_word(p.bit)] |= _mask(p.bit);
+  }
+
+  // Return false if the hash was never inserted, true if it probably was
+  bool may_contain(std::size_t h) const {
+    Probe p = _probe(h);
+    for (unsigned i = 0; i < _hashes; ++i, p.bit += p.step)
+      if (!(p.block->words[_word(p.bit)] & _mask(p.bit)))
+        return false;
+    return true;
+  }
+
+private:
+  struct alignas(64) Block {
+    std::uint64_t words[8];
+  };
+  static constexpr std::size_t _block_bits = 512;
+
+  Block *_blocks;
+  // Always a power of 2
+  std::size_t _block_count;
+  // Number of bits set per key
+  unsigned _hashes;
+
+  // Block of a hash and positions of its bits in the block, by double hashing
+  struct Probe {
+    Block *block;
+    std::uint64_t bit, step;
+  };
+  Probe _probe(std::size_t h) const {
+    // Independent of the low bits of mix_hash that select the table buckets
+    std::uint64_t x = multiply_mix(h, 0x9e3779b97f4a7c15ull);
+    return {&_blocks[x & (_block_count - 1)], x >> 32, (x >> 41) | 1};
+  }
+  // Word and mask of a bit of a block, the position is taken modulo 512
+  static std::size_t _word(std::uint64_t bit) { return (bit >> 6) & 7; }
+  static std::uint64_t _mask(std::uint64_t bit) {
+    return std::uint64_t(1) << (bit & 63);
+  }
+};
+
+inline BloomFilter::BloomFilter(const BloomFilter &f)
+    : _blocks(f._blocks ? new Block[f._block_count] : nullptr),
+      _block_count(f._block_count), _hashes(f._hashes) {
+  std::copy(f._blocks, f._blocks + (f._blocks ? _block_count : 0), _blocks);
+}
+
+inline void BloomFilter::reset(std::size_t keys, std::size_t bits_per_key) {
+  delete[] std::exchange(_blocks, nullptr);
+  _block_count = 0;
+  if (bits_per_key == 0)
+    return;
+
+  // The false positive rate is the lowest with bits_per_key * ln 2 bits set
+  // per key
+  _hashes = static_cast<unsigned>(std::clamp(
+      std::lround(static_cast<double>(bits_per_key) * 0.693), 1l, 16l));
+  std::size_t bits = std::max<std::size_t>(keys, 1) * bits_per_key;
+  _block_count = next_power_of_2((bits + _block_bits - 1) / _block_bits);
+  _blocks = new Block[_block_count]();
+}
+} // namespace details
+
+#endif // GUARD_DETAILS_BLOOM_FILTER_HPP__
@@ -1,9 +1,17 @@
 #ifndef GUARD_DETAILS_HASH_HPP__
 #define GUARD_DETAILS_HASH_HPP__
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <type_traits>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace details {
 // Is true_type if T is the same type as one of the types in the Args list
 template <class T, class... Args> struct is_one_of;
@@ -18,39 +26,266 @@ template <class T> struct decay { typedef T value; };
 template <class T> struct decay<const T *> { typedef T value; };
 template <class T> struct decay<T *> { typedef T value; };
 template <class T> using decay_t = typename decay<T>::value;
+
+// True when called during the evaluation of a constant expression. Without
+// compiler support, always false: hashing strings in constant expressions is
+// then unavailable.
+constexpr bool is_constant_evaluated() {
+#if defined(__cpp_lib_is_constant_evaluated)
+  return std::is_constant_evaluated();
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+  return __builtin_is_constant_evaluated();
+#else
+  return false;
+#endif
+#elif (defined(__GNUC__) && __GNUC__ >= 9) ||                                  \
+    (defined(_MSC_VER) && _MSC_VER >= 1925)
+  return __builtin_is_constant_evaluated();
+#else
+  return false;
+#endif
+}
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) &&                \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool big_endian = true;
+#else
+constexpr bool big_endian = false;
+#endif
+
+// Finalizer of MurmurHash3. Every bit of the input affects every bit of the
+// output, so keys differing only by a few bits (sequential or strided
+// integers hashed with the identity) are spread over the whole range. Tables
+// can then pick a position with a mask on the low bits instead of a modulo.
+constexpr std::size_t mix_hash(std::size_t h) {
+  if constexpr (sizeof(std::size_t) >= 8) {
+    h ^= h >> 33;
+    h *= static_cast<std::size_t>(0xff51afd7ed558ccdull);
+    h ^= h >> 33;
+    h *= static_cast<std::size_t>(0xc4ceb9fe1a85ec53ull);
+    h ^= h >> 33;
+  } else {
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+  }
+  return h;
+}
+
+// Multiply a and b as 128 bit integers, store the low half of the result in a
+// and the high half in b
+constexpr void multiply_128(std::uint64_t &a, std::uint64_t &b) {
+#if defined(__SIZEOF_INT128__)
+  __extension__ typedef unsigned __int128 uint128;
+  uint128 r = static_cast<uint128>(a) * b;
+  a = static_cast<std::uint64_t>(r);
+  b = static_cast<std::uint64_t>(r >> 64);
+#else
+#if defined(_MSC_VER) && defined(_M_X64)
+  if (!is_constant_evaluated()) {
+    a = _umul128(a, b, &b);
+    return;
+  }
+#endif
+  std::uint64_t ha = a >> 32, hb = b >> 32, la = a & 0xffffffff,
+                lb = b & 0xffffffff;
+  std::uint64_t hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+  std::uint64_t t = ll + (hl << 32);
+  std::uint64_t carry = t < ll;
+  std::uint64_t low = t + (lh << 32);
+  carry += low < t;
+  a = low;
+  b = hh + (hl >> 32) + (lh >> 32) + carry;
+#endif
+}
+
+// Fold the 128 bit product of a and b into 64 bits
+constexpr std::uint64_t multiply_mix(std::uint64_t a, std::uint64_t b) {
+  multiply_128(a, b);
+  return a ^ b;
+}
+
+// Sources of the bytes read by hash_bytes. MemoryBytes reads the bytes of any
+// object, CharacterBytes extracts the bytes of an array of characters one by
+// one, in the order they have in memory, which is allowed in constant
+// expressions. Both give the same result for the same characters.
+struct MemoryBytes {
+  std::uint64_t operator[](std::size_t i) const { return p[i]; }
+  std::uint64_t read_64(std::size_t i) const {
+    std::uint64_t v;
+    std::memcpy(&v, p + i, 8);
+    return v;
+  }
+  std::uint64_t read_32(std::size_t i) const {
+    std::uint32_t v;
+    std::memcpy(&v, p + i, 4);
+    return v;
+  }
+
+  const unsigned char *p;
+};
+
+template <class CharT> struct CharacterBytes {
+  constexpr std::uint64_t operator[](std::size_t i) const {
+    std::size_t shift = i % sizeof(CharT);
+    if (big_endian)
+      shift = sizeof(CharT) - 1 - shift;
+    auto c = static_cast<std::make_unsigned_t<CharT>>(p[i / sizeof(CharT)]);
+    return (static_cast<std::uint64_t>(c) >> (8 * shift)) & 0xff;
+  }
+  constexpr std::uint64_t read_64(std::size_t i) const { return read(i, 8); }
+  constexpr std::uint64_t read_32(std::size_t i) const { return read(i, 4); }
+
+  // Integer made of the n bytes starting at i, as a memory read would give
+  constexpr std::uint64_t read(std::size_t i, std::size_t n) const {
+    std::uint64_t v = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+      if (big_endian)
+        v = (v << 8) | (*this)[i + k];
+      else
+        v |= (*this)[i + k] << (8 * k);
+    }
+    return v;
+  }
+
+  const CharT *p;
+};
+
+// Hash of a sequence of bytes, after wyhash (final version 4) by Wang Yi.
+// The input is consumed 8 or 16 bytes at a time, each block being folded into
+// the state with a single 64x64->128 bit multiplication. Inputs longer than 48
+// bytes are processed in 3 independent lanes so that the multiplications of a
+// block can execute in parallel.
+template <class Bytes>
+constexpr std::uint64_t hash_bytes_from(Bytes p, std::size_t len,
+                                        std::uint64_t seed = 0) {
+  constexpr std::uint64_t secret[4] = {
+      0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+      0x4d5a2da51de1aa47ull};
+  // Offset of the next bytes to read
+  std::size_t o = 0;
+  std::uint64_t a = 0, b = 0;
+
+  seed ^= multiply_mix(seed ^ secret[0], secret[1]);
+  if (len <= 16) {
+    if (len >= 4) {
+      // Two possibly overlapping reads cover any length between 4 and 16
+      std::size_t middle = (len >> 3) << 2;
+      a = (p.read_32(0) << 32) | p.read_32(middle);
+      b = (p.read_32(len - 4) << 32) | p.read_32(len - 4 - middle);
+    } else if (len > 0) {
+      a = (p[0] << 16) | (p[len >> 1] << 8) | p[len - 1];
+    }
+  } else {
+    std::size_t i = len;
+    if (i > 48) {
+      std::uint64_t lane1 = seed, lane2 = seed;
+      do {
+        seed = multiply_mix(p.read_64(o) ^ secret[1], p.read_64(o + 8) ^ seed);
+        lane1 = multiply_mix(p.read_64(o + 16) ^ secret[2],
+                             p.read_64(o + 24) ^ lane1);
+        lane2 = multiply_mix(p.read_64(o + 32) ^ secret[3],
+                             p.read_64(o + 40) ^ lane2);
+        o += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= lane1 ^ lane2;
+    }
+    while (i > 16) {
+      seed = multiply_mix(p.read_64(o) ^ secret[1], p.read_64(o + 8) ^ seed);
+      i -= 16;
+      o += 16;
+    }
+    a = p.read_64(o + i - 16);
+    b = p.read_64(o + i - 8);
+  }
+
+  a ^= secret[1];
+  b ^= seed;
+  multiply_128(a, b);
+  return multiply_mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+// Hash of the bytes of any object
+inline std::uint64_t hash_bytes(const void *data, std::size_t len,
+                                std::uint64_t seed = 0) {
+  return hash_bytes_from(
+      MemoryBytes{static_cast<const unsigned char *>(data)}, len, seed);
+}
+
+// Is true_type if the hash functor declares an is_transparent member type,
+// meaning that it accepts other types than the keys of the table
+template <class H, class = void> struct is_transparent : std::false_type {};
+template <class H>
+struct is_transparent<H, std::void_t<typename H::is_transparent>>
+    : std::true_type {};
+
+// Return a hash functor for a new table: one with fresh random keys if the
+// functor provides them through a static random() member, as seeded_hash
+// does, a default constructed one otherwise
+template <class H, class = void> struct has_random_keys : std::false_type {};
+template <class H>
+struct has_random_keys<H, std::void_t<decltype(H::random())>>
+    : std::true_type {};
+template <class H> H make_hash_functor() {
+  if constexpr (has_random_keys<H>::value)
+    return H::random();
+  else
+    return H();
+}
+
+// Smallest power of 2 greater or equal to n
+constexpr std::size_t next_power_of_2(std::size_t n) {
+  std::size_t p = 1;
+  while (p < n)
+    p <<= 1;
+  return p;
+}
 } // namespace details
 
 template <class T, class = void> struct hash;
 
 template <class T>
 struct hash<T, std::enable_if_t<std::is_integral<T>::value>> {
-  std::size_t operator()(const T &t) { return static_cast<T>(t); }
+  constexpr std::size_t operator()(const T &t) const {
+    return static_cast<T>(t);
+  }
 };
 
 template <class T>
-struct hash<T, std::enable_if_t<details::is_one_of<
-                   details::decay_t<std::decay_t<T>>, char, wchar_t>::value>> {
-  std::size_t operator()(const T &p) {
-    // Forward to hash<string> for simplicity but in production code separating
-    // that specialization in a different file would allow for more granular
-    // dependency management, since std::string is not necessary to every
-    // program using hash tables
-    return hash<std::basic_string<details::decay_t<T>>>()(
-        std::basic_string<details::decay_t<T>>(p));
+struct hash<T, std::enable_if_t<std::is_pointer<std::decay_t<T>>::value &&
+                                details::is_one_of<
+                                    details::decay_t<std::decay_t<T>>, char,
+                                    wchar_t>::value>> {
+  constexpr std::size_t operator()(const T &p) const {
+    // Forward to hash<string_view> to hash the characters in place, without
+    // building a temporary string
+    return hash<std::basic_string_view<details::decay_t<std::decay_t<T>>>>()(
+        p);
   }
 };
 
+// Strings and string views of the same characters hash to the same value.
+// The functor is transparent: tables of strings accept string views and C
+// strings as lookup keys, without building a temporary string.
 template <class T>
-struct hash<T, std::enable_if_t<details::is_one_of<std::decay_t<T>, std::string,
-                                                   std::wstring>::value>> {
-  std::size_t operator()(const T &t) {
-    // djb2 by Dan Berstein
-    std::size_t hash = 5381;
-
-    for (auto c = t.begin(); c != t.end(); ++c)
-      hash = ((hash << 5) + hash) + *c;
+struct hash<T, std::enable_if_t<details::is_one_of<
+                   std::decay_t<T>, std::string, std::wstring, std::string_view,
+                   std::wstring_view>::value>> {
+  typedef void is_transparent;
+  typedef typename std::decay_t<T>::value_type char_type;
 
-    return hash;
+  // Usable in constant expressions, giving the same value as at runtime
+  constexpr std::size_t
+  operator()(std::basic_string_view<char_type> t) const {
+    std::size_t len = t.size() * sizeof(char_type);
+    if (details::is_constant_evaluated())
+      return static_cast<std::size_t>(details::hash_bytes_from(
+          details::CharacterBytes<char_type>{t.data()}, len));
+    return static_cast<std::size_t>(details::hash_bytes(t.data(), len));
   }
 };
 
@@ -0,0 +1,680 @@
+#ifndef GUARD_DETAILS_HASH_TABLE_BASE_HPP__
+#define GUARD_DETAILS_HASH_TABLE_BASE_HPP__
+
+#include "bloom_filter.hpp"
+#include "hash.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+namespace details {
+// Hint the processor that the memory at the given address will be read soon
+inline void prefetch(const void *address) {
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  _mm_prefetch(static_cast<const char *>(address), _MM_HINT_T0);
+#else
+  (void)address;
+#endif
+}
+
+// Key extraction for tables storing keys only
+struct identity {
+  template <class T> const T &operator()(const T &t) const { return t; }
+};
+
+// Key extraction for tables storing (key, value) pairs
+struct first_of_pair {
+  template <class P> const auto &operator()(const P &p) const {
+    return p.first;
+  }
+};
+
+// Hashes are cached by default for keys that are not trivially copyable,
+// for which hashing and comparing is typically expensive (strings)
+template <class Key>
+struct cache_hash_by_default
+    : std::integral_constant<bool, !std::is_trivially_copyable<Key>::value> {};
+
+// Element stored in the buckets of a table, along with its hash if the table
+// caches them
+template <class Value, bool CacheHash> struct HashEntry {
+  template <class... Args>
+  HashEntry(std::size_t h, Args &&... args)
+      : value(std::forward<Args>(args)...), hash(h) {}
+
+  // True if the entry may hold a value with the given hash
+  bool may_match(std::size_t h) const { return hash == h; }
+  // Record the hash of the value, if it was not known at construction
+  void set_hash(std::size_t h) { hash = h; }
+
+  Value value;
+  std::size_t hash;
+};
+
+template <class Value> struct HashEntry<Value, false> {
+  template <class... Args>
+  HashEntry(std::size_t, Args &&... args)
+      : value(std::forward<Args>(args)...) {}
+
+  bool may_match(std::size_t) const { return true; }
+  void set_hash(std::size_t) {}
+
+  Value value;
+};
+
+// Node of the chains of elements stored in the buckets of a table. Nodes are
+// allocated once per element and only relinked afterward, the elements are
+// never moved nor copied by the table.
+template <class Value, bool CacheHash>
+struct HashNode : HashEntry<Value, CacheHash> {
+  template <class... Args>
+  HashNode(HashNode *n, std::size_t h, Args &&... args)
+      : HashEntry<Value, CacheHash>(h, std::forward<Args>(args)...), next(n) {}
+  // Copy the element and its hash, not the link
+  explicit HashNode(const HashNode &n)
+      : HashEntry<Value, CacheHash>(n), next(nullptr) {}
+
+  HashNode *next;
+};
+
+// Shape of a table at the time it is requested
+struct HashTableStatistics {
+  std::size_t size, bucket_count;
+  float load_factor;
+  // chain_lengths[n] is the number of buckets holding n elements, up to the
+  // longest chain. Many long chains with a low load factor are the sign of a
+  // hash function unfit for the keys.
+  std::vector<std::size_t> chain_lengths;
+  std::size_t longest_chain;
+  // Number of rehashes and time spent moving elements to new buckets since the
+  // table was created. Only measured if HASH_TABLE_STATISTICS is defined,
+  // which must then be the case in every translation unit of the program.
+  std::size_t rehash_count;
+  std::chrono::nanoseconds rehash_time;
+};
+
+// Separate chaining machinery shared by HashTable and HashMap. Elements of
+// type Value are stored in chains of nodes, indexed, hashed and
+// compared by the Key that KeyOf extracts from them. If CacheHash is true, the
+// full hash of each element is stored next to it: resizing never calls the
+// hash functor, and elements are only compared to keys with the same hash.
+template <class Value, class Key, class KeyOf, class HashFunctor,
+          bool CacheHash>
+struct HashTableBase {
+  std::size_t size() const { return _size; }
+
+  // Return the number of buckets in the table
+  std::size_t bucket_count() const { return _capacity; }
+
+  // Return the average number of elements per bucket
+  float load_factor() const;
+
+  // Return or set the load factor above which the table grows. Setting it
+  // rehashes the table if the current load exceeds the new maximum.
+  // Throw a std::invalid_argument if the value is not strictly positive
+  float max_load_factor() const { return _max_load_factor; }
+  void max_load_factor(float);
+
+  // Set the number of buckets to at least the given count, and at least enough
+  // to hold the current elements without exceeding the max load factor
+  void rehash(std::size_t);
+
+  // Make room for the given number of elements without exceeding the max load
+  // factor, so that inserting them triggers no further rehash
+  void reserve(std::size_t);
+
+  // Return or set the number of buckets moved to the new bucket array on each
+  // insertion or deletion while the table grows. With a non-zero value, a
+  // growing table keeps both bucket arrays and migrates them incrementally
+  // instead of rehashing every element at once. 0 (the default) disables
+  // incremental rehashing and completes any migration in progress.
+  std::size_t incremental_rehash() const { return _rehash_step; }
+  void incremental_rehash(std::size_t);
+
+  // Return true if a migration to a new bucket array is in progress
+  bool rehashing() const { return _old_storage != nullptr; }
+
+  // Return or set the number of bits per element of a Bloom filter consulted
+  // before searching the buckets. Most lookups of absent keys then return
+  // without reading the buckets, at the cost of updating the filter on
+  // insertion and rebuilding it when the table grows. Removed keys stay in the
+  // filter until it is rebuilt. About 10 bits per element give 1% of false
+  // positives. 0 (the default) disables the filter. Hits pay for the filter
+  // on top of the search: it only helps when most lookups miss (see
+  // bench/bloom_filter.cpp).
+  std::size_t bloom_filter() const { return _filter_bits; }
+  void bloom_filter(std::size_t);
+
+  // Return a copy of the hash functor of the table. A functor with random
+  // keys, such as seeded_hash, has different keys in every table.
+  HashFunctor hash_function() const { return _hasher; }
+
+  // Walk the buckets to gather statistics on the table. The rehash counters
+  // are 0 unless HASH_TABLE_STATISTICS is defined, otherwise the table holds
+  // no data nor performs any work for the statistics.
+  HashTableStatistics statistics() const;
+
+  // Call the function on each element of the table, in no particular order
+  template <class F> void for_each(F) const;
+
+protected:
+  HashTableBase();
+  explicit HashTableBase(const HashFunctor &);
+  HashTableBase(const HashTableBase &);
+  HashTableBase(HashTableBase &&);
+  ~HashTableBase();
+
+  // Return the element with the given key, or nullptr if there is none. The
+  // hash of the key can be given if it is already known. The key can be of
+  // any type the hash functor accepts and that compares equal to Key.
+  template <class K> Value *_find(const K &);
+  template <class K> const Value *_find(const K &) const;
+  template <class K> Value *_find(const K &, std::size_t);
+
+  // Store a new element built from the arguments in the bucket of the given
+  // hash, the caller guarantees that its key is not in the table yet. Return
+  // the stored element, which stays at the same address until it is removed.
+  template <class... Args> Value &_insert(std::size_t, Args &&...);
+
+  // Build an element from the arguments in a new node, then store it unless
+  // an element with the same key is in the table already. Return the element
+  // with the key in the table, and true if it is the new one.
+  template <class... Args> std::pair<Value *, bool> _emplace(Args &&...);
+
+  // Remove the element with the given key, if any
+  template <class K> void _erase(const K &);
+
+  // Call f(key, hash) for each key of the range. Keys are processed by
+  // batches: the whole batch is hashed and its buckets prefetched, then the
+  // first node of each bucket is prefetched before the first call, so that the
+  // cache misses of a batch overlap instead of following each other.
+  template <class It, class F> void _for_each_hashed(It, It, F);
+
+  // Move up to the given number of buckets of the old array to the new one
+  void _migrate(std::size_t);
+
+  // Return the bucket holding the elements with the given hash, which is in
+  // the old array if it has not been migrated yet. A bucket is the pointer to
+  // the first node of its chain.
+  typedef HashEntry<Value, CacheHash> Entry;
+  typedef HashNode<Value, CacheHash> Node;
+  Node *&_store_for_hash(std::size_t);
+
+  template <class K> std::size_t _hash(const K &key) { return _hasher(key); }
+
+  // Return the hash of a stored element, without calling the hash functor if
+  // it is cached
+  std::size_t _hash_of(const Entry &entry) {
+    if constexpr (CacheHash)
+      return entry.hash;
+    else
+      return _hash(KeyOf()(entry.value));
+  }
+
+private:
+  static constexpr std::size_t _batch_size = 16;
+
+  // _capacity is always a power of 2
+  std::size_t _size, _capacity;
+  Node **_storage;
+  float _max_load_factor;
+
+  // Bucket array being emptied during an incremental rehash. The buckets
+  // before _migrated have already been moved to _storage.
+  std::size_t _old_capacity, _migrated, _rehash_step;
+  Node **_old_storage;
+
+  std::size_t _filter_bits;
+  BloomFilter _filter;
+
+  // Kept for the lifetime of the table, the keys of a seeded functor must not
+  // change while elements are stored
+  HashFunctor _hasher;
+
+#ifdef HASH_TABLE_STATISTICS
+  std::size_t _rehash_count = 0;
+  std::chrono::nanoseconds _rehash_time{0};
+#endif
+
+  // Return the position of the bucket associated with the hash
+  std::size_t _bucket_for(std::size_t h) const {
+    return details::mix_hash(h) & (_capacity - 1);
+  }
+
+  // Minimal number of buckets to hold the given number of elements
+  std::size_t _buckets_for(std::size_t) const;
+  void _resize(std::size_t);
+  // Grow the table if needed to store one more element, and return the bucket
+  // where an element with the given hash goes
+  Node *&_bucket_for_insertion(std::size_t);
+  // Return a new bucket array holding copies of the chains of the given one
+  static Node **_clone(Node *const *, std::size_t);
+  // Size the filter for the capacity of the table and add every element
+  void _rebuild_filter();
+  // Move the first node of the bucket to the front of its bucket in _storage
+  void _relink_front(Node *&);
+  // Delete the bucket array and the nodes of its chains
+  static void _free(Node **, std::size_t);
+  // Grow the table, at once or incrementally depending on the settings
+  void _grow();
+};
+
+// Enabled if the hash functor is transparent and K is not the key type, so that
+// lookup overloads taking a K do not compete with the ones taking a Key
+template <class HashFunctor, class Key, class K>
+using enable_if_transparent_t =
+    std::enable_if_t<is_transparent<HashFunctor>::value &&
+                     !std::is_same<std::decay_t<K>, Key>::value>;
+
+template <class V, class K, class KO, class H, bool C>
+HashTableBase<V, K, KO, H, C>::HashTableBase()
+    : HashTableBase(make_hash_functor<H>()) {}
+
+template <class V, class K, class KO, class H, bool C>
+HashTableBase<V, K, KO, H, C>::HashTableBase(const H &hasher)
+    : _size(0), _capacity(2), _storage(new Node *[2]()),
+      _max_load_factor(1), _old_capacity(0), _migrated(0), _rehash_step(0),
+      _old_storage(nullptr), _filter_bits(0), _hasher(hasher) {}
+
+template <class V, class K, class KO, class H, bool C>
+HashTableBase<V, K, KO, H, C>::HashTableBase(const HashTableBase &h)
+    : _size(h._size), _capacity(h._capacity),
+      _storage(_clone(h._storage, h._capacity)),
+      _max_load_factor(h._max_load_factor), _old_capacity(h._old_capacity),
+      _migrated(h._migrated), _rehash_step(h._rehash_step),
+      _old_storage(nullptr), _filter_bits(h._filter_bits),
+      _filter(h._filter), _hasher(h._hasher) {
+  // The copy has the same layout as the original, including a migration in
+  // progress: no element is hashed nor compared
+  if (h._old_storage) {
+    try {
+      _old_storage = _clone(h._old_storage, h._old_capacity);
+    } catch (...) {
+      _free(_storage, _capacity);
+      throw;
+    }
+  }
+}
+
+template <class V, class K, class KO, class H, bool C>
+HashTableBase<V, K, KO, H, C>::HashTableBase(HashTableBase &&h)
+    : _size(std::exchange(h._size, 0)),
+      _capacity(std::exchange(h._capacity, 2)),
+      _storage(std::exchange(h._storage, new Node *[2]())),
+      _max_load_factor(h._max_load_factor),
+      _old_capacity(std::exchange(h._old_capacity, 0)),
+      _migrated(std::exchange(h._migrated, 0)), _rehash_step(h._rehash_step),
+      _old_storage(std::exchange(h._old_storage, nullptr)),
+      _filter_bits(std::exchange(h._filter_bits, 0)),
+      _filter(std::move(h._filter)), _hasher(h._hasher) {}
+
+template <class V, class K, class KO, class H, bool C>
+HashTableBase<V, K, KO, H, C>::~HashTableBase() {
+  _free(_storage, _capacity);
+  _free(_old_storage, _old_capacity);
+}
+
+template <class V, class K, class KO, class H, bool C>
+template <class Lookup>
+V *HashTableBase<V, K, KO, H, C>::_find(const Lookup &key) {
+  return _find(key, _hash(key));
+}
+
+template <class V, class K, class KO, class H, bool C>
+template <class Lookup>
+V *HashTableBase<V, K, KO, H, C>::_find(const Lookup &key, std::size_t h) {
+  if (_filter && !_filter.may_contain(h))
+    return nullptr;
+  for (Node *n = _store_for_hash(h); n; n = n->next)
+    if (n->may_match(h) && KO()(n->value) == key)
+      return &n->value;
+  return nullptr;
+}
+
+template <class V, class K, class KO, class H, bool C>
+template <class Lookup>
+const V *HashTableBase<V, K, KO, H, C>::_find(const Lookup &key) const {
+  return const_cast<HashTableBase *>(this)->_find(key);
+}
+
+template <class V, class K, class KO, class H, bool C>
+template <class... Args>
+V &HashTableBase<V, K, KO, H, C>::_insert(std::size_t h, Args &&... args) {
+  // Build the element directly in a new node at the front of its chain
+  Node *&store = _bucket_for_insertion(h);
+  store = new Node(store, h, std::forward<Args>(args)...);
+  ++_size;
+  return store->value;
+}
+
+template <class V, class K, class KO, class H, bool C>
+template <class... Args>
+std::pair<V *, bool> HashTableBase<V, K, KO, H, C>::_emplace(Args &&... args) {
+  // The key is only known once the element is built
+  std::unique_ptr<Node> node(new Node(nullptr, 0, std::forward<Args>(args)...));
+  const K &key = KO()(node->value);
+  std::size_t h = _hash(key);
+  if (V *existing = _find(key, h))
+    return {existing, false};
+
+  node->set_hash(h);
+  Node *&store = _bucket_for_insertion(h);
+  node->next = store;
+  store = node.release();
+  ++_size;
+  return {&store->value, true};
+}
+
+template <class V, class K, class KO, class H, bool C>
+template <class Lookup>
+void HashTableBase<V, K, KO, H, C>::_erase(const Lookup &key) {
+  _migrate(_rehash_step);
+
+  std::size_t h = _hash(key);
+  for (Node **link = &_store_for_hash(h); *link; link = &(*link)->next) {
+    Node *n = *link;
+    if (n->may_match(h) && KO()(n->value) == key) {
+      *link = n->next;
+      delete n;
+      --_size;
+      return;
+    }
+  }
+}
+
+template <class V, class K, class KO, class H, bool C>
+template <class It, class F>
+void HashTableBase<V, K, KO, H, C>::_for_each_hashed(It first, It last, F f) {
+  std::size_t hashes[_batch_size];
+  Node **buckets[_batch_size];
+  while (first != last) {
+    // With single pass iterators, keys can only be read once: the batch is
+    // reduced to a single key
+    std::size_t count = 0;
+    It it = first;
+    if constexpr (std::is_base_of<
+                      std::forward_iterator_tag,
+                      typename std::iterator_traits<It>::iterator_category>::
+                      value) {
+      for (; it != last && count < _batch_size; ++it, ++count) {
+        hashes[count] = _hash(*it);
+        buckets[count] = &_store_for_hash(hashes[count]);
+        prefetch(buckets[count]);
+      }
+      // The buckets of the batch are being loaded, the nodes they point to can
+      // be requested in turn
+      for (std::size_t i = 0; i < count; ++i)
+        if (Node *n = *buckets[i])
+          prefetch(n);
+    } else {
+      hashes[count++] = _hash(*it);
+    }
+
+    for (std::size_t i = 0; i < count; ++i, ++first)
+      f(*first, hashes[i]);
+  }
+}
+
+template <class V, class K, class KO, class H, bool C>
+float HashTableBase<V, K, KO, H, C>::load_factor() const {
+  return static_cast<float>(_size) / static_cast<float>(_capacity);
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::max_load_factor(float factor) {
+  if (!(factor > 0))
+    throw std::invalid_argument(
+        "HashTable::max_load_factor : the factor must be strictly positive");
+  _max_load_factor = factor;
+  if (_size > _capacity * _max_load_factor)
+    _resize(_buckets_for(_size));
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::rehash(std::size_t buckets) {
+  std::size_t capacity =
+      details::next_power_of_2(std::max(buckets, _buckets_for(_size)));
+  if (capacity != _capacity)
+    _resize(capacity);
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::reserve(std::size_t count) {
+  std::size_t capacity = _buckets_for(count);
+  if (capacity > _capacity)
+    _resize(capacity);
+}
+
+template <class V, class K, class KO, class H, bool C>
+HashTableStatistics HashTableBase<V, K, KO, H, C>::statistics() const {
+  HashTableStatistics stats{_size, _capacity, load_factor(), {}, 0, 0,
+                            std::chrono::nanoseconds(0)};
+#ifdef HASH_TABLE_STATISTICS
+  stats.rehash_count = _rehash_count;
+  stats.rehash_time = _rehash_time;
+#endif
+
+  auto count_chains = [&stats](Node *const *buckets, std::size_t first,
+                               std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      std::size_t length = 0;
+      for (const Node *n = buckets[i]; n; n = n->next)
+        ++length;
+      if (length >= stats.chain_lengths.size())
+        stats.chain_lengths.resize(length + 1);
+      ++stats.chain_lengths[length];
+      stats.longest_chain = std::max(stats.longest_chain, length);
+    }
+  };
+  count_chains(_storage, 0, _capacity);
+  // Buckets of the old array that are still in use count as well
+  if (_old_storage)
+    count_chains(_old_storage, _migrated, _old_capacity);
+  return stats;
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::bloom_filter(std::size_t bits) {
+  _filter_bits = bits;
+  _rebuild_filter();
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::_rebuild_filter() {
+  // Sized for the number of elements that triggers the next growth
+  _filter.reset(std::max(_size, static_cast<std::size_t>(_capacity *
+                                                         _max_load_factor)),
+                _filter_bits);
+  if (!_filter)
+    return;
+  auto add = [this](Node *const *buckets, std::size_t capacity) {
+    for (std::size_t i = 0; buckets && i < capacity; ++i)
+      for (const Node *n = buckets[i]; n; n = n->next)
+        _filter.insert(_hash_of(*n));
+  };
+  add(_storage, _capacity);
+  add(_old_storage, _old_capacity);
+}
+
+template <class V, class K, class KO, class H, bool C>
+template <class F>
+void HashTableBase<V, K, KO, H, C>::for_each(F f) const {
+  for (std::size_t i = 0; i < _capacity; ++i)
+    for (const Node *n = _storage[i]; n; n = n->next)
+      f(n->value);
+  if (_old_storage)
+    for (std::size_t i = _migrated; i < _old_capacity; ++i)
+      for (const Node *n = _old_storage[i]; n; n = n->next)
+        f(n->value);
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::incremental_rehash(std::size_t buckets) {
+  _rehash_step = buckets;
+  if (_rehash_step == 0)
+    _migrate(_old_capacity);
+}
+
+template <class V, class K, class KO, class H, bool C>
+std::size_t
+HashTableBase<V, K, KO, H, C>::_buckets_for(std::size_t count) const {
+  return details::next_power_of_2(
+      static_cast<std::size_t>(std::ceil(count / _max_load_factor)));
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::_resize(std::size_t capacity) {
+  _migrate(_old_capacity);
+#ifdef HASH_TABLE_STATISTICS
+  auto start = std::chrono::steady_clock::now();
+  ++_rehash_count;
+#endif
+
+  std::size_t old_capacity = _capacity;
+  Node **old_storage = _storage;
+  _storage = new Node *[capacity]();
+  _capacity = capacity;
+
+  // recalculate every position of the existing nodes, then link them in the
+  // new array. No element is copied and no node is allocated.
+  for (std::size_t i = 0; i < old_capacity; ++i) {
+    while (old_storage[i])
+      _relink_front(old_storage[i]);
+  }
+
+  delete[] old_storage;
+  _rebuild_filter();
+#ifdef HASH_TABLE_STATISTICS
+  _rehash_time += std::chrono::steady_clock::now() - start;
+#endif
+}
+
+template <class V, class K, class KO, class H, bool C>
+typename HashTableBase<V, K, KO, H, C>::Node *&
+HashTableBase<V, K, KO, H, C>::_bucket_for_insertion(std::size_t h) {
+  _migrate(_rehash_step);
+
+  // Resize if the load exceeds the maximum, the position has to be computed
+  // afterward
+  if (_size + 1 > _capacity * _max_load_factor)
+    _grow();
+
+  if (_filter)
+    _filter.insert(h);
+  return _store_for_hash(h);
+}
+
+template <class V, class K, class KO, class H, bool C>
+typename HashTableBase<V, K, KO, H, C>::Node **
+HashTableBase<V, K, KO, H, C>::_clone(Node *const *buckets,
+                                      std::size_t capacity) {
+  Node **copy = new Node *[capacity]();
+  try {
+    // Chains are copied in order, appending after the last copied node
+    for (std::size_t i = 0; i < capacity; ++i) {
+      Node **tail = &copy[i];
+      for (const Node *n = buckets[i]; n; n = n->next) {
+        *tail = new Node(*n);
+        tail = &(*tail)->next;
+      }
+    }
+  } catch (...) {
+    _free(copy, capacity);
+    throw;
+  }
+  return copy;
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::_relink_front(Node *&bucket) {
+  Node *n = bucket;
+  bucket = n->next;
+  Node *&store = _storage[_bucket_for(_hash_of(*n))];
+  n->next = store;
+  store = n;
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::_free(Node **buckets,
+                                          std::size_t capacity) {
+  if (!buckets)
+    return;
+  for (std::size_t i = 0; i < capacity; ++i) {
+    while (Node *n = buckets[i]) {
+      buckets[i] = n->next;
+      delete n;
+    }
+  }
+  delete[] buckets;
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::_grow() {
+  if (_rehash_step == 0) {
+    _resize(_capacity * 2);
+    return;
+  }
+
+  // Only one migration can be in progress at a time
+  _migrate(_old_capacity);
+
+  Node **new_array = new Node *[_capacity * 2]();
+  _old_storage = std::exchange(_storage, new_array);
+  _old_capacity = std::exchange(_capacity, _capacity * 2);
+  _migrated = 0;
+  // The filter does not depend on the buckets, it is rebuilt at once
+  _rebuild_filter();
+#ifdef HASH_TABLE_STATISTICS
+  ++_rehash_count;
+#endif
+}
+
+template <class V, class K, class KO, class H, bool C>
+void HashTableBase<V, K, KO, H, C>::_migrate(std::size_t buckets) {
+  if (!_old_storage)
+    return;
+#ifdef HASH_TABLE_STATISTICS
+  auto start = std::chrono::steady_clock::now();
+#endif
+
+  std::size_t end = std::min(_old_capacity, _migrated + buckets);
+  for (; _migrated < end; ++_migrated) {
+    while (_old_storage[_migrated])
+      _relink_front(_old_storage[_migrated]);
+  }
+
+  if (_migrated == _old_capacity) {
+    // Every chain has been emptied, only the array is left
+    delete[] std::exchange(_old_storage, nullptr);
+    _old_capacity = 0;
+    _migrated = 0;
+  }
+#ifdef HASH_TABLE_STATISTICS
+  _rehash_time += std::chrono::steady_clock::now() - start;
+#endif
+}
+
+template <class V, class K, class KO, class H, bool C>
+typename HashTableBase<V, K, KO, H, C>::Node *&
+HashTableBase<V, K, KO, H, C>::_store_for_hash(std::size_t h) {
+  if (_old_storage) {
+    std::size_t pos = details::mix_hash(h) & (_old_capacity - 1);
+    if (pos >= _migrated)
+      return _old_storage[pos];
+  }
+  return _storage[_bucket_for(h)];
+}
+} // namespace details
+
+#endif // GUARD_DETAILS_HASH_TABLE_BASE_HPP__
@@ -0,0 +1,102 @@
+#ifndef GUARD_DETAILS_MAPPED_FILE_HPP__
+#define GUARD_DETAILS_MAPPED_FILE_HPP__
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace details {
+// Read-only view of a whole file mapped in memory. Pages are loaded on first
+// access and shared with every other process mapping the same file.
+struct MappedFile {
+  // Map the file at the given path
+  // Throw a std::runtime_error if the file cannot be opened or mapped
+  explicit MappedFile(const std::string &);
+  MappedFile(MappedFile &&m) noexcept
+      : _data(std::exchange(m._data, nullptr)),
+        _size(std::exchange(m._size, 0)) {}
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile();
+
+  const unsigned char *data() const { return _data; }
+  std::size_t size() const { return _size; }
+
+private:
+  const unsigned char *_data;
+  std::size_t _size;
+
+  [[noreturn]] static void _fail(const std::string &path) {
+    throw std::runtime_error("MappedFile error: cannot map " + path);
+  }
+};
+
+#if defined(_WIN32)
+inline MappedFile::MappedFile(const std::string &path)
+    : _data(nullptr), _size(0) {
+  HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    _fail(path);
+  LARGE_INTEGER size;
+  HANDLE mapping = nullptr;
+  if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping)
+    _fail(path);
+  // The view keeps the mapping alive after its handle is closed
+  void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  CloseHandle(mapping);
+  if (!view)
+    _fail(path);
+  _data = static_cast<const unsigned char *>(view);
+  _size = static_cast<std::size_t>(size.QuadPart);
+}
+
+inline MappedFile::~MappedFile() {
+  if (_data)
+    UnmapViewOfFile(_data);
+}
+#else
+inline MappedFile::MappedFile(const std::string &path)
+    : _data(nullptr), _size(0) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    _fail(path);
+  struct stat st;
+  void *view = MAP_FAILED;
+  if (::fstat(fd, &st) == 0 && st.st_size > 0)
+    view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ,
+                  MAP_SHARED, fd, 0);
+  // The mapping stays valid after the descriptor is closed
+  ::close(fd);
+  if (view == MAP_FAILED)
+    _fail(path);
+  _data = static_cast<const unsigned char *>(view);
+  _size = static_cast<std::size_t>(st.st_size);
+}
+
+inline MappedFile::~MappedFile() {
+  if (_data)
+    ::munmap(const_cast<unsigned char *>(_data), _size);
+}
+#endif
+} // namespace details
+
+#endif // GUARD_DETAILS_MAPPED_FILE_HPP__
@@ -0,0 +1,58 @@
+#ifndef GUARD_DETAILS_MAYBE_HPP__
+#define GUARD_DETAILS_MAYBE_HPP__
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace details {
+// Structure that may contain a value or not
+template <class T> struct Maybe {
+  constexpr Maybe(T * = nullptr);
+  template <class U> constexpr Maybe(const Maybe<U> &);
+
+  // Return the contained value if it exists. Throw otherwise
+  const T &operator*() const;
+  const T *operator->() const;
+  T &operator*();
+  T *operator->();
+
+  // Evaluate to true a value is contained, false otherwise
+  operator bool() const;
+
+private:
+  friend Maybe<std::add_const_t<T>>;
+  T *_pointer;
+};
+
+template <class T>
+constexpr Maybe<T>::Maybe(T *pointer) : _pointer(pointer) {}
+
+template <class T>
+template <class U>
+constexpr Maybe<T>::Maybe(const Maybe<U> &mb) : _pointer(mb._pointer) {}
+
+template <class T> const T &Maybe<T>::operator*() const {
+  return const_cast<Maybe<T> *>(this)->operator*();
+}
+
+template <class T> const T *Maybe<T>::operator->() const {
+  return const_cast<Maybe<T> *>(this)->operator->();
+}
+
+template <class T> T &Maybe<T>::operator*() {
+  if (!_pointer)
+    throw std::runtime_error(
+        "HashTable::Maybe error: dereferencing null pointer");
+  return *_pointer;
+}
+
+template <class T> T *Maybe<T>::operator->() {
+  return _pointer ? _pointer
+                  : throw std::runtime_error(
+                        "HashTable::Maybe error: dereferencing null pointer");
+}
+
+template <class T> Maybe<T>::operator bool() const { return _pointer; }
+} // namespace details
+
+#endif // GUARD_DETAILS_MAYBE_HPP__
@@ -0,0 +1,170 @@
+#ifndef GUARD_DETAILS_SEEDED_HASH_HPP__
+#define GUARD_DETAILS_SEEDED_HASH_HPP__
+
+#include "hash.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace details {
+constexpr std::uint64_t rotate_left(std::uint64_t x, int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+// SipHash by Jean-Philippe Aumasson and Daniel J. Bernstein, with C rounds
+// per 8 byte block and D finalization rounds. Unlike hash_bytes, its output
+// cannot be predicted without the 128 bit key, so crafting inputs that
+// collide requires knowing the key. SipHash-1-3 is used for hash tables,
+// SipHash-2-4 is the original, more conservative variant.
+template <int C, int D>
+std::uint64_t sip_hash(const void *data, std::size_t len, std::uint64_t k0,
+                       std::uint64_t k1) {
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  std::uint64_t v0 = k0 ^ 0x736f6d6570736575ull;
+  std::uint64_t v1 = k1 ^ 0x646f72616e646f6dull;
+  std::uint64_t v2 = k0 ^ 0x6c7967656e657261ull;
+  std::uint64_t v3 = k1 ^ 0x7465646279746573ull;
+  auto round = [&]() {
+    v0 += v1;
+    v1 = rotate_left(v1, 13);
+    v1 ^= v0;
+    v0 = rotate_left(v0, 32);
+    v2 += v3;
+    v3 = rotate_left(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = rotate_left(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = rotate_left(v1, 17);
+    v1 ^= v2;
+    v2 = rotate_left(v2, 32);
+  };
+  auto compress = [&](std::uint64_t m) {
+    v3 ^= m;
+    for (int i = 0; i < C; ++i)
+      round();
+    v0 ^= m;
+  };
+
+  // Blocks are read as little endian integers
+  std::size_t o = 0;
+  for (; o + 8 <= len; o += 8) {
+    std::uint64_t m = 0;
+    if (big_endian) {
+      for (int i = 7; i >= 0; --i)
+        m = (m << 8) | p[o + i];
+    } else {
+      std::memcpy(&m, p + o, 8);
+    }
+    compress(m);
+  }
+  std::uint64_t last = static_cast<std::uint64_t>(len) << 56;
+  for (std::size_t i = 0; o + i < len; ++i)
+    last |= static_cast<std::uint64_t>(p[o + i]) << (8 * i);
+  compress(last);
+
+  v2 ^= 0xff;
+  for (int i = 0; i < D; ++i)
+    round();
+  return v0 ^ v1 ^ v2 ^ v3;
+}
+
+// 128 bit key of SipHash
+struct SipKeys {
+  std::uint64_t k0, k1;
+};
+
+// Return new random keys. The random device is only read once per process,
+// for a 128 bit secret drawn 32 bits at a time. The keys are the SipHash-2-4
+// of a counter under that secret: predicting them requires the whole secret.
+inline SipKeys random_keys() {
+  static const SipKeys secret = [] {
+    std::random_device device;
+    auto draw = [&device] {
+      std::uint64_t high = device();
+      return (high << 32) | static_cast<std::uint32_t>(device());
+    };
+    std::uint64_t k0 = draw();
+    return SipKeys{k0, draw()};
+  }();
+  static std::atomic<std::uint64_t> counter{0};
+  std::uint64_t n = counter.fetch_add(2, std::memory_order_relaxed), m = n + 1;
+  return {sip_hash<2, 4>(&n, sizeof(n), secret.k0, secret.k1),
+          sip_hash<2, 4>(&m, sizeof(m), secret.k0, secret.k1)};
+}
+
+// Keys shared by the seeded hash functors of the process
+inline const SipKeys &process_keys() {
+  static const SipKeys keys = random_keys();
+  return keys;
+}
+
+// Keys of a seeded hash functor. Derived must be default constructible.
+template <class Derived> struct SeededHash {
+  // Functor with the keys of the process, identical in every table
+  SeededHash() : k0(process_keys().k0), k1(process_keys().k1) {}
+  // Functor with the given keys, to reproduce the hashes of another process
+  SeededHash(std::uint64_t key0, std::uint64_t key1) : k0(key0), k1(key1) {}
+
+  // Functor with fresh random keys, used by the tables that keep their
+  // functor (HashTable and HashMap)
+  static Derived random() {
+    SipKeys keys = random_keys();
+    Derived d;
+    d.k0 = keys.k0;
+    d.k1 = keys.k1;
+    return d;
+  }
+
+  std::uint64_t k0, k1;
+
+protected:
+  std::size_t _hash(const void *data, std::size_t len) const {
+    return static_cast<std::size_t>(sip_hash<1, 3>(data, len, k0, k1));
+  }
+};
+} // namespace details
+
+// Keyed hash functors, resisting inputs crafted to collide. hash is fast but
+// predictable: anyone who knows the hash function can compute values that
+// all fall in the same bucket and turn every lookup into a linear search.
+// seeded_hash uses SipHash-1-3 with secret random 128 bit keys, drawn once
+// per table by HashTable and HashMap, and once per process otherwise. The
+// keys of every table derive from a 128 bit secret of the process, read from
+// std::random_device on first use. It is slower than hash and should be used
+// for tables filled with untrusted input.
+template <class T, class = void> struct seeded_hash;
+
+template <class T>
+struct seeded_hash<T, std::enable_if_t<std::is_integral<T>::value>>
+    : details::SeededHash<seeded_hash<T>> {
+  using details::SeededHash<seeded_hash<T>>::SeededHash;
+
+  std::size_t operator()(const T &t) const {
+    std::uint64_t v = static_cast<std::uint64_t>(t);
+    return this->_hash(&v, sizeof(v));
+  }
+};
+
+// Strings and string views of the same characters hash to the same value, and
+// tables of strings accept string views and C strings as lookup keys
+template <class T>
+struct seeded_hash<T, std::enable_if_t<details::is_one_of<
+                          std::decay_t<T>, std::string, std::wstring,
+                          std::string_view, std::wstring_view>::value>>
+    : details::SeededHash<seeded_hash<T>> {
+  using details::SeededHash<seeded_hash<T>>::SeededHash;
+  typedef void is_transparent;
+  typedef typename std::decay_t<T>::value_type char_type;
+
+  std::size_t operator()(std::basic_string_view<char_type> t) const {
+    return this->_hash(t.data(), t.size() * sizeof(char_type));
+  }
+};
+
+#endif // GUARD_DETAILS_SEEDED_HASH_HPP__
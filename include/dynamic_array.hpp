@@ -2,20 +2,28 @@
 #define GUARD_DYNAMIC_ARRAY_HPP__
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdlib>
 #include <initializer_list>
+#include <memory>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
+// Elements are constructed in raw storage as they are added: the capacity
+// beyond the size holds no object, and types without a default constructor
+// can be stored.
 template <class Type> class DynamicArray {
 public:
   // Constructs an empty array of size 0
   constexpr DynamicArray();
 
-  // Create an empty array with the given size
-  constexpr DynamicArray(std::size_t);
+  // Create an array of the given size, filled with value initialized elements
+  DynamicArray(std::size_t);
 
   // Create an array containing the given elements
-  constexpr DynamicArray(const std::initializer_list<Type> &list);
+  DynamicArray(const std::initializer_list<Type> &list);
 
   DynamicArray(const DynamicArray &);
   DynamicArray(DynamicArray &&) noexcept;
@@ -26,6 +34,11 @@ public:
 
   // Add an element at the end of the array
   void push_back(const Type &);
+  void push_back(Type &&);
+
+  // Add an element constructed in place from the arguments at the end of the
+  // array, and return it
+  template <class... Args> Type &emplace_back(Args &&...);
 
   // Remove the last element in the array
   void pop();
@@ -43,19 +56,27 @@ public:
   // Return the number of elements in the array
   constexpr std::size_t size() const;
 
-  // Return the size of the array in memory
+  // Return the number of elements the array can hold without reallocating
   constexpr std::size_t capacity() const;
 
-  // Change the capacity of the array
+  // Make room for at least the given number of elements, without changing the
+  // size of the array
+  void reserve(std::size_t);
+
+  // Change the number of elements of the array, removing the last ones or
+  // adding value initialized ones
   void resize(std::size_t);
 
+  // Reduce the capacity to the number of elements
+  void shrink_to_fit();
+
   // Sort the elements in the array according to the comparison function given
   // in argument (quicksort)
   template <class Compare = std::less<Type>>
   void sort(const Compare & = Compare());
 
   typedef Type *iterator;
-  typedef const iterator const_iterator;
+  typedef const Type *const_iterator;
 
   // Return an iterator to the first element
   iterator begin();
@@ -70,6 +91,20 @@ private:
   std::size_t _capacity;
   Type *_array;
 
+  // Trivially copyable elements are allocated with malloc and moved to a new
+  // block with a single realloc, which may even extend the block in place
+  static constexpr bool _relocatable =
+      std::is_trivially_copyable<Type>::value &&
+      alignof(Type) <= alignof(std::max_align_t);
+
+  static Type *_allocate(std::size_t);
+  static void _deallocate(Type *, std::size_t);
+  // Move the elements to a block of the given capacity, at least the size
+  void _reallocate(std::size_t);
+  // Capacity after the array gets full
+  std::size_t _next_capacity() const { return (_capacity + 1) * 2; }
+  void _destroy_from(std::size_t);
+
   template <class Function>
   void _sort(const Function &, std::size_t, std::size_t);
   template <class Function>
@@ -81,26 +116,40 @@ constexpr DynamicArray<Type>::DynamicArray()
     : _size(0), _capacity(0), _array(nullptr) {}
 
 template <class Type>
-constexpr DynamicArray<Type>::DynamicArray(std::size_t size)
-    : _size(size), _capacity(_capacity), _array(new Type[size]) {}
+DynamicArray<Type>::DynamicArray(std::size_t size)
+    : _size(0), _capacity(size), _array(_allocate(size)) {
+  try {
+    std::uninitialized_value_construct_n(_array, size);
+  } catch (...) {
+    _deallocate(_array, _capacity);
+    throw;
+  }
+  _size = size;
+}
 
 template <class Type>
-constexpr DynamicArray<Type>::DynamicArray(
-    const std::initializer_list<Type> &list)
-    : _size(list.size()), _capacity(list.size()),
-      _array(new Type[list.size()]) {
-  std::size_t i = 0;
-  for (auto it = list.begin(); it < list.end(); ++it, ++i)
-    _array[i] = *it;
+DynamicArray<Type>::DynamicArray(const std::initializer_list<Type> &list)
+    : _size(0), _capacity(list.size()), _array(_allocate(list.size())) {
+  try {
+    std::uninitialized_copy(list.begin(), list.end(), _array);
+  } catch (...) {
+    _deallocate(_array, _capacity);
+    throw;
+  }
+  _size = list.size();
 }
 
 template <class Type>
 DynamicArray<Type>::DynamicArray(const DynamicArray &arr)
-    : _size(arr.size()), _capacity(arr.capacity()),
-      _array(new Type[arr.size()]) {
-  for (std::size_t i = 0; i < _size; ++i) {
-    _array[i] = arr[i];
+    : _size(0), _capacity(arr.size()), _array(_allocate(arr.size())) {
+  // uninitialized_copy copies trivially copyable elements with memmove
+  try {
+    std::uninitialized_copy(arr.begin(), arr.end(), _array);
+  } catch (...) {
+    _deallocate(_array, _capacity);
+    throw;
   }
+  _size = arr.size();
 }
 
 template <class Type>
@@ -110,44 +159,53 @@ DynamicArray<Type>::DynamicArray(DynamicArray &&arr) noexcept
       _array(std::exchange(arr._array, nullptr)) {}
 
 template <class Type> DynamicArray<Type>::~DynamicArray() {
-  if (_array != nullptr)
-    delete[] _array;
+  _destroy_from(0);
+  _deallocate(_array, _capacity);
 }
 
 template <class Type>
 DynamicArray<Type> &DynamicArray<Type>::operator=(const DynamicArray &arr) {
-  Type *array = nullptr;
-  if (arr.size() != 0) {
-    array = new Type[arr.capacity()];
-    for (std::size_t i = 0; i < arr.size(); ++i) {
-      array[i] = arr[i];
-    }
-  }
-  std::swap(_array, array);
-  _capacity = arr.capacity();
-  _size = arr.size();
-  delete[] array;
+  if (this != &arr)
+    *this = DynamicArray(arr);
   return *this;
 }
 
 template <class Type>
 DynamicArray<Type> &DynamicArray<Type>::operator=(DynamicArray &&arr) noexcept {
-  Type *array = std::exchange(arr._array, nullptr);
-  std::swap(array, _array);
+  _destroy_from(0);
+  _deallocate(_array, _capacity);
+  _array = std::exchange(arr._array, nullptr);
   _size = std::exchange(arr._size, 0);
   _capacity = std::exchange(arr._capacity, 0);
-  delete[] array;
   return *this;
 }
 
 template <class Type> void DynamicArray<Type>::push_back(const Type &t) {
-  if (_size >= _capacity) {
-    resize((_capacity + 1) * 2);
+  emplace_back(t);
+}
+
+template <class Type> void DynamicArray<Type>::push_back(Type &&t) {
+  emplace_back(std::move(t));
+}
+
+template <class Type>
+template <class... Args>
+Type &DynamicArray<Type>::emplace_back(Args &&... args) {
+  if (_size < _capacity) {
+    ::new (_array + _size) Type(std::forward<Args>(args)...);
+  } else {
+    // The arguments may refer to elements of the array, the new element is
+    // built before they move
+    Type value(std::forward<Args>(args)...);
+    _reallocate(_next_capacity());
+    ::new (_array + _size) Type(std::move(value));
   }
-  _array[_size++] = t;
+  return _array[_size++];
 }
 
-template <class Type> void DynamicArray<Type>::pop() { --_size; }
+template <class Type> void DynamicArray<Type>::pop() {
+  _array[--_size].~Type();
+}
 
 template <class Type>
 constexpr const Type &DynamicArray<Type>::operator[](std::size_t pos) const {
@@ -177,19 +235,84 @@ inline constexpr std::size_t DynamicArray<Type>::capacity() const {
   return _capacity;
 }
 
-template <class Type>
-void DynamicArray<Type>::resize(std::size_t new_capacity) {
-  Type *tmp = new Type[new_capacity];
+template <class Type> void DynamicArray<Type>::reserve(std::size_t capacity) {
+  if (capacity > _capacity)
+    _reallocate(capacity);
+}
 
-  std::size_t max_bound = std::min(new_capacity, _size);
+template <class Type> void DynamicArray<Type>::resize(std::size_t size) {
+  if (size <= _size) {
+    _destroy_from(size);
+    return;
+  }
+  reserve(size);
+  std::uninitialized_value_construct(_array + _size, _array + size);
+  _size = size;
+}
+
+template <class Type> void DynamicArray<Type>::shrink_to_fit() {
+  if (_size < _capacity)
+    _reallocate(_size);
+}
+
+template <class Type> Type *DynamicArray<Type>::_allocate(std::size_t count) {
+  if (count == 0)
+    return nullptr;
+  if constexpr (_relocatable) {
+    void *block = std::malloc(count * sizeof(Type));
+    if (!block)
+      throw std::bad_alloc();
+    return static_cast<Type *>(block);
+  } else {
+    return std::allocator<Type>().allocate(count);
+  }
+}
 
-  for (std::size_t i = 0; i < max_bound; ++i)
-    tmp[i] = std::move(_array[i]);
+template <class Type>
+void DynamicArray<Type>::_deallocate(Type *array, std::size_t capacity) {
+  if (!array)
+    return;
+  if constexpr (_relocatable)
+    std::free(array);
+  else
+    std::allocator<Type>().deallocate(array, capacity);
+}
 
-  std::swap(tmp, _array);
-  delete[] tmp;
+template <class Type>
+void DynamicArray<Type>::_reallocate(std::size_t capacity) {
+  if constexpr (_relocatable) {
+    if (capacity == 0) {
+      std::free(std::exchange(_array, nullptr));
+    } else {
+      void *block = std::realloc(_array, capacity * sizeof(Type));
+      if (!block)
+        throw std::bad_alloc();
+      _array = static_cast<Type *>(block);
+    }
+  } else {
+    Type *array = _allocate(capacity);
+    // Elements are copied instead of moved if moving them may throw, so that
+    // the array is left unchanged on failure
+    std::size_t moved = 0;
+    try {
+      for (; moved < _size; ++moved)
+        ::new (array + moved) Type(std::move_if_noexcept(_array[moved]));
+    } catch (...) {
+      std::destroy_n(array, moved);
+      _deallocate(array, capacity);
+      throw;
+    }
+    std::destroy_n(_array, _size);
+    _deallocate(_array, _capacity);
+    _array = array;
+  }
+  _capacity = capacity;
+}
 
-  _capacity = new_capacity;
+template <class Type> void DynamicArray<Type>::_destroy_from(std::size_t pos) {
+  if (pos < _size)
+    std::destroy(_array + pos, _array + _size);
+  _size = std::min(_size, pos);
 }
 
 template <class Type>
@@ -221,8 +344,8 @@ void DynamicArray<Type>::sort(const Compare &compare) {
 }
 
 namespace details {
-std::size_t median_of_three(std::size_t top, std::size_t middle,
-                            std::size_t bottom) {
+inline std::size_t median_of_three(std::size_t top, std::size_t middle,
+                                   std::size_t bottom) {
 
   return std::max(std::min(top, middle),
                   std::min(std::max(top, middle), bottom)); // Simplified
@@ -0,0 +1,373 @@
+#ifndef GUARD_FROZEN_HASH_TABLE_HPP__
+#define GUARD_FROZEN_HASH_TABLE_HPP__
+
+#include "details/hash.hpp"
+#include "details/maybe.hpp"
+#include "dynamic_array.hpp"
+#include "hash_table.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Immutable hash table built once from a set of values, for tables that are
+// only read after their creation. The values are stored in a flat array
+// with very few spare slots, at positions given by a perfect hash function
+// computed during construction: a lookup reads one displacement seed and
+// compares the searched value to a single element.
+//
+// The perfect hash function is built following the CHD (compress, hash and
+// displace) algorithm. The values are distributed among buckets of about 4
+// values each. Starting with the largest, each bucket is assigned the first
+// seed that places all its values in free slots of the array. The array has
+// about 1.5% more slots than values, in a full array the last buckets would
+// need about as many seeds as there are slots. The spare slots hold copies
+// of a stored value, which never match a lookup landing there.
+template <class Type, class HashFunctor = hash<Type>> struct FrozenHashTable {
+  // Constructs an empty table
+  FrozenHashTable();
+  // Constructs a table holding the values of the list, of the array or of the
+  // hash table.
+  // Throw a std::runtime_error if a value appears twice
+  FrozenHashTable(const std::initializer_list<Type> &);
+  FrozenHashTable(const DynamicArray<Type> &);
+  template <bool CacheHash>
+  FrozenHashTable(const HashTable<Type, HashFunctor, CacheHash> &);
+  FrozenHashTable(const FrozenHashTable &);
+  FrozenHashTable(FrozenHashTable &&);
+
+  ~FrozenHashTable();
+
+  // Return the value matching the argument.
+  // Throw a std::out_of_range if the value is not in the table
+  const Type &operator[](const Type &) const;
+
+  std::size_t size() const { return _size; }
+
+  // Structure that may contain a value or not
+  template <class T> using Maybe = details::Maybe<T>;
+
+  // Returns a dereferenceable structure that may contain the searched value
+  // Implicitely convertible to bool with true value if the searched value is
+  // contained, false value if the value is not contained
+  Maybe<const Type> find(const Type &) const;
+
+  // Return true if the value is in the table, false otherwise
+  bool contains(const Type &) const;
+
+  // Lookups with a different type than the stored one, available if the hash
+  // functor is transparent
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  Maybe<const Type> find(const K &) const;
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  bool contains(const K &) const;
+
+private:
+  typedef std::aligned_storage_t<sizeof(Type), alignof(Type)> Slot;
+
+  std::size_t _size, _slot_count, _bucket_count;
+  // Salt of the hash function, changed if no perfect hash function is found
+  std::uint64_t _salt;
+  std::uint32_t *_seeds;
+  Slot *_slots;
+
+  // Average number of values per bucket
+  static constexpr std::size_t _bucket_load = 4;
+  // Number of seeds tried for a bucket before starting over with a new salt
+  static constexpr std::uint32_t _max_seed = 1u << 24;
+
+  // Slots in a table of the given size, a load factor of about 0.985
+  static std::size_t _slots_for(std::size_t size) {
+    return size + size / 64 + 1;
+  }
+
+  // Both mixes give 64 bits whatever the size of std::size_t, as _reduce
+  // keeps the high bits
+  std::size_t _bucket_of(std::size_t h) const {
+    std::uint64_t mixed = details::multiply_mix(h ^ _salt,
+                                                0x9e3779b97f4a7c15ull);
+    return _reduce(mixed, _bucket_count);
+  }
+  std::size_t _slot_of(std::size_t h, std::uint32_t seed) const {
+    std::uint64_t mixed = details::multiply_mix(
+        h ^ 0x2d358dccaa6c78a5ull, (_salt + seed) ^ 0x8bb84b93962eacc9ull);
+    return _reduce(mixed, _slot_count);
+  }
+  // Map x uniformly to [0, n) with a multiplication instead of a modulo
+  static std::size_t _reduce(std::uint64_t x, std::size_t n) {
+    std::uint64_t high = n;
+    details::multiply_128(x, high);
+    return static_cast<std::size_t>(high);
+  }
+
+  Type &_value(std::size_t pos) const {
+    return *reinterpret_cast<Type *>(&_slots[pos]);
+  }
+
+  // Return the element matching the key, or nullptr if there is none
+  template <class K> const Type *_find(const K &) const;
+
+  struct Item {
+    std::size_t bucket, hash;
+    const Type *value;
+  };
+
+  // Build the perfect hash function and copy the values in their slots
+  void _build(const std::vector<const Type *> &);
+  // Try to build the perfect hash function with the current salt, storing the
+  // slot of each value in positions. Return false if a bucket cannot be placed
+  bool _place(std::vector<Item> &, std::vector<std::size_t> &);
+  void _destroy();
+};
+
+template <class T, class H>
+FrozenHashTable<T, H>::FrozenHashTable()
+    : _size(0), _slot_count(0), _bucket_count(1), _salt(0),
+      _seeds(new std::uint32_t[1]()), _slots(nullptr) {}
+
+template <class T, class H>
+FrozenHashTable<T, H>::FrozenHashTable(const std::initializer_list<T> &list)
+    : FrozenHashTable() {
+  std::vector<const T *> values;
+  values.reserve(list.size());
+  for (const auto &e : list)
+    values.push_back(&e);
+  _build(values);
+}
+
+template <class T, class H>
+FrozenHashTable<T, H>::FrozenHashTable(const DynamicArray<T> &array)
+    : FrozenHashTable() {
+  std::vector<const T *> values;
+  values.reserve(array.size());
+  for (std::size_t i = 0; i < array.size(); ++i)
+    values.push_back(&array[i]);
+  _build(values);
+}
+
+template <class T, class H>
+template <bool C>
+FrozenHashTable<T, H>::FrozenHashTable(const HashTable<T, H, C> &table)
+    : FrozenHashTable() {
+  std::vector<const T *> values;
+  values.reserve(table.size());
+  table.for_each([&values](const T &e) { values.push_back(&e); });
+  _build(values);
+}
+
+template <class T, class H>
+FrozenHashTable<T, H>::FrozenHashTable(const FrozenHashTable<T, H> &h)
+    : _size(h._size), _slot_count(0), _bucket_count(h._bucket_count),
+      _salt(h._salt), _seeds(new std::uint32_t[_bucket_count]),
+      _slots(nullptr) {
+  // The hash function does not depend on the elements' addresses, the layout
+  // can be copied as is
+  std::copy(h._seeds, h._seeds + _bucket_count, _seeds);
+  try {
+    _slots = new Slot[h._slot_count];
+    for (; _slot_count < h._slot_count; ++_slot_count)
+      ::new (&_slots[_slot_count]) T(h._value(_slot_count));
+  } catch (...) {
+    _destroy();
+    throw;
+  }
+}
+
+template <class T, class H>
+FrozenHashTable<T, H>::FrozenHashTable(FrozenHashTable<T, H> &&h)
+    : FrozenHashTable() {
+  // The seed left to h is allocated before anything is taken from h, so that
+  // h still owns its elements if the allocation throws
+  std::swap(_size, h._size);
+  std::swap(_slot_count, h._slot_count);
+  std::swap(_bucket_count, h._bucket_count);
+  std::swap(_salt, h._salt);
+  std::swap(_seeds, h._seeds);
+  std::swap(_slots, h._slots);
+}
+
+template <class T, class H> FrozenHashTable<T, H>::~FrozenHashTable() {
+  _destroy();
+}
+
+template <class T, class H>
+const T &FrozenHashTable<T, H>::operator[](const T &value) const {
+  auto maybe = find(value);
+  if (!maybe)
+    throw std::out_of_range(
+        "HashTable::operator[] : the given key is not in the table");
+  return *maybe;
+}
+
+template <class T, class H>
+typename FrozenHashTable<T, H>::template Maybe<const T>
+FrozenHashTable<T, H>::find(const T &value) const {
+  return Maybe<const T>(_find(value));
+}
+
+template <class T, class H>
+bool FrozenHashTable<T, H>::contains(const T &value) const {
+  return _find(value) != nullptr;
+}
+
+template <class T, class H>
+template <class K, class>
+typename FrozenHashTable<T, H>::template Maybe<const T>
+FrozenHashTable<T, H>::find(const K &key) const {
+  return Maybe<const T>(_find(key));
+}
+
+template <class T, class H>
+template <class K, class>
+bool FrozenHashTable<T, H>::contains(const K &key) const {
+  return _find(key) != nullptr;
+}
+
+template <class T, class H>
+template <class K>
+const T *FrozenHashTable<T, H>::_find(const K &key) const {
+  if (_size == 0)
+    return nullptr;
+  std::size_t h = H()(key);
+  const T &candidate = _value(_slot_of(h, _seeds[_bucket_of(h)]));
+  return candidate == key ? &candidate : nullptr;
+}
+
+template <class T, class H>
+void FrozenHashTable<T, H>::_build(const std::vector<const T *> &values) {
+  std::size_t size = values.size();
+  if (size == 0)
+    return;
+
+  std::vector<Item> items(size);
+  for (std::size_t i = 0; i < size; ++i)
+    items[i] = Item{0, H()(*values[i]), values[i]};
+
+  // Values with the same hash can never be told apart by the hash function
+  std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+    return a.hash < b.hash;
+  });
+  for (std::size_t i = 1; i < size; ++i) {
+    if (items[i].hash != items[i - 1].hash)
+      continue;
+    if (*items[i].value == *items[i - 1].value)
+      throw std::runtime_error("HashTable insertion error: an element with "
+                               "the same value exists already");
+    throw std::runtime_error("FrozenHashTable construction error: distinct "
+                             "elements have the same hash");
+  }
+
+  std::uint32_t *seeds = new std::uint32_t[size / _bucket_load + 1];
+  delete[] std::exchange(_seeds, seeds);
+  _bucket_count = size / _bucket_load + 1;
+  _size = size;
+  _slot_count = _slots_for(size);
+
+  std::vector<std::size_t> positions(size);
+  // A failure is extremely unlikely, a few salts are more than enough
+  bool placed = false;
+  for (int attempt = 0; attempt < 8 && !placed; ++attempt) {
+    _salt = details::mix_hash(_salt + 1);
+    placed = _place(items, positions);
+  }
+  if (!placed) {
+    _size = _slot_count = 0;
+    throw std::runtime_error(
+        "FrozenHashTable construction error: no perfect hash function found");
+  }
+
+  // The spare slots copy any value, a lookup can only find it in its own slot
+  std::vector<const T *> sources(_slot_count, items[0].value);
+  for (std::size_t i = 0; i < size; ++i)
+    sources[positions[i]] = items[i].value;
+
+  _slots = new Slot[_slot_count];
+  std::size_t built = 0;
+  try {
+    for (; built < _slot_count; ++built)
+      ::new (&_slots[built]) T(*sources[built]);
+  } catch (...) {
+    for (std::size_t i = 0; i < built; ++i)
+      _value(i).~T();
+    delete[] std::exchange(_slots, nullptr);
+    _size = _slot_count = 0;
+    throw;
+  }
+}
+
+template <class T, class H>
+bool FrozenHashTable<T, H>::_place(std::vector<Item> &items,
+                                   std::vector<std::size_t> &positions) {
+  // Group the values by bucket
+  std::vector<std::size_t> order(items.size());
+  std::vector<std::size_t> bucket_sizes(_bucket_count);
+  std::vector<std::size_t> bucket_starts(_bucket_count + 1);
+  for (auto &item : items) {
+    item.bucket = _bucket_of(item.hash);
+    ++bucket_sizes[item.bucket];
+  }
+  for (std::size_t b = 0; b < _bucket_count; ++b)
+    bucket_starts[b + 1] = bucket_starts[b] + bucket_sizes[b];
+  {
+    std::vector<std::size_t> next(bucket_starts.begin(),
+                                  bucket_starts.end() - 1);
+    for (std::size_t i = 0; i < items.size(); ++i)
+      order[next[items[i].bucket]++] = i;
+  }
+
+  // Largest buckets first, while most slots are still free
+  std::vector<std::size_t> buckets(_bucket_count);
+  for (std::size_t b = 0; b < _bucket_count; ++b)
+    buckets[b] = b;
+  std::stable_sort(buckets.begin(), buckets.end(),
+                   [&bucket_sizes](std::size_t a, std::size_t b) {
+                     return bucket_sizes[a] > bucket_sizes[b];
+                   });
+
+  std::vector<bool> occupied(_slot_count);
+  std::vector<std::size_t> candidate;
+  for (std::size_t b : buckets) {
+    std::size_t first = bucket_starts[b], count = bucket_sizes[b];
+    _seeds[b] = 0;
+    if (count == 0)
+      continue;
+
+    std::uint32_t seed = 0;
+    for (; seed < _max_seed; ++seed) {
+      candidate.clear();
+      bool fits = true;
+      for (std::size_t i = 0; i < count && fits; ++i) {
+        std::size_t pos = _slot_of(items[order[first + i]].hash, seed);
+        fits = !occupied[pos] && std::find(candidate.begin(), candidate.end(),
+                                           pos) == candidate.end();
+        candidate.push_back(pos);
+      }
+      if (fits)
+        break;
+    }
+    if (seed == _max_seed)
+      return false;
+
+    _seeds[b] = seed;
+    for (std::size_t i = 0; i < count; ++i) {
+      occupied[candidate[i]] = true;
+      positions[order[first + i]] = candidate[i];
+    }
+  }
+  return true;
+}
+
+template <class T, class H> void FrozenHashTable<T, H>::_destroy() {
+  for (std::size_t i = 0; i < _slot_count && _slots; ++i)
+    _value(i).~T();
+  delete[] _slots;
+  delete[] _seeds;
+}
+
+#endif // GUARD_FROZEN_HASH_TABLE_HPP__
@@ -0,0 +1,245 @@
+#ifndef GUARD_HASH_MAP_HPP__
+#define GUARD_HASH_MAP_HPP__
+
+#include "details/hash.hpp"
+#include "details/hash_table_base.hpp"
+#include "details/maybe.hpp"
+#include "details/seeded_hash.hpp"
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+// Hash table associating values to keys. Only the keys are hashed and
+// compared, the values are never copied during lookups.
+// CacheHash selects whether the hash of each key is stored next to it
+template <class Key, class Value, class HashFunctor = hash<Key>,
+          bool CacheHash = details::cache_hash_by_default<Key>::value>
+struct HashMap
+    : details::HashTableBase<std::pair<const Key, Value>, Key,
+                             details::first_of_pair, HashFunctor, CacheHash> {
+  typedef std::pair<const Key, Value> value_type;
+
+  // Constructs an empty map
+  HashMap() = default;
+  // Constructs a map initialized with the list of (key, value) pairs
+  HashMap(const std::initializer_list<value_type> &);
+  HashMap(const HashMap &) = default;
+  HashMap(HashMap &&) = default;
+
+  // Structure that may contain a value or not
+  template <class T> using Maybe = details::Maybe<T>;
+
+  // Insert a new (key, value) pair into the map
+  // Throw a std::runtime_error if the key is already in the map
+  void insert(const value_type &);
+
+  // If the key is not in the map, insert it with a value constructed from the
+  // remaining arguments, otherwise do nothing.
+  // Return the value associated with the key, and true if it was inserted
+  template <class... Args>
+  std::pair<Maybe<Value>, bool> try_emplace(const Key &, Args &&...);
+  template <class... Args>
+  std::pair<Maybe<Value>, bool> try_emplace(Key &&, Args &&...);
+
+  // Insert the key with the given value if the key is not in the map,
+  // otherwise assign the value to the existing entry.
+  // Return the value associated with the key, and true if it was inserted
+  template <class M>
+  std::pair<Maybe<Value>, bool> insert_or_assign(const Key &, M &&);
+  template <class M>
+  std::pair<Maybe<Value>, bool> insert_or_assign(Key &&, M &&);
+
+  // Return the value associated with the key, inserting a default constructed
+  // value first if the key is not in the map
+  Value &operator[](const Key &);
+  Value &operator[](Key &&);
+
+  // Return the value associated with the key
+  // Throw a std::out_of_range if the key is not in the map
+  const Value &at(const Key &) const;
+  Value &at(const Key &);
+
+  // Remove the key and its value from the map
+  void erase(const Key &);
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Key, K>>
+  void erase(const K &);
+
+  // Returns a dereferenceable structure that may contain the value associated
+  // with the key. Implicitely convertible to bool with true value if the key
+  // is in the map, false value otherwise
+  Maybe<const Value> find(const Key &) const;
+  Maybe<Value> find(const Key &);
+
+  // Return true if the key is in the map, false otherwise
+  bool contains(const Key &) const;
+
+  // Lookups with a different type than the key, available if the hash functor
+  // is transparent (as hash<std::string> is). A map with string keys can then
+  // be searched with string views or C strings without allocation.
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Key, K>>
+  Maybe<const Value> find(const K &) const;
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Key, K>>
+  Maybe<Value> find(const K &);
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Key, K>>
+  bool contains(const K &) const;
+
+private:
+  template <class K, class... Args>
+  std::pair<Maybe<Value>, bool> _try_emplace(K &&, Args &&...);
+  template <class K, class M>
+  std::pair<Maybe<Value>, bool> _insert_or_assign(K &&, M &&);
+};
+
+template <class K, class V, class H, bool C>
+HashMap<K, V, H, C>::HashMap(const std::initializer_list<value_type> &list) {
+  for (const auto &e : list) {
+    insert(e);
+  }
+}
+
+template <class K, class V, class H, bool C>
+void HashMap<K, V, H, C>::insert(const value_type &pair) {
+  std::size_t h = this->_hash(pair.first);
+  if (this->_find(pair.first, h))
+    throw std::runtime_error("HashMap insertion error: an element with the "
+                             "same key exists already");
+  this->_insert(h, pair);
+}
+
+template <class K, class V, class H, bool C>
+template <class... Args>
+std::pair<typename HashMap<K, V, H, C>::template Maybe<V>, bool>
+HashMap<K, V, H, C>::try_emplace(const K &key, Args &&... args) {
+  return _try_emplace(key, std::forward<Args>(args)...);
+}
+
+template <class K, class V, class H, bool C>
+template <class... Args>
+std::pair<typename HashMap<K, V, H, C>::template Maybe<V>, bool>
+HashMap<K, V, H, C>::try_emplace(K &&key, Args &&... args) {
+  return _try_emplace(std::move(key), std::forward<Args>(args)...);
+}
+
+template <class K, class V, class H, bool C>
+template <class M>
+std::pair<typename HashMap<K, V, H, C>::template Maybe<V>, bool>
+HashMap<K, V, H, C>::insert_or_assign(const K &key, M &&value) {
+  return _insert_or_assign(key, std::forward<M>(value));
+}
+
+template <class K, class V, class H, bool C>
+template <class M>
+std::pair<typename HashMap<K, V, H, C>::template Maybe<V>, bool>
+HashMap<K, V, H, C>::insert_or_assign(K &&key, M &&value) {
+  return _insert_or_assign(std::move(key), std::forward<M>(value));
+}
+
+template <class K, class V, class H, bool C>
+V &HashMap<K, V, H, C>::operator[](const K &key) {
+  return *try_emplace(key).first;
+}
+
+template <class K, class V, class H, bool C>
+V &HashMap<K, V, H, C>::operator[](K &&key) {
+  return *try_emplace(std::move(key)).first;
+}
+
+template <class K, class V, class H, bool C>
+const V &HashMap<K, V, H, C>::at(const K &key) const {
+  return const_cast<HashMap<K, V, H, C> *>(this)->at(key);
+}
+
+template <class K, class V, class H, bool C>
+V &HashMap<K, V, H, C>::at(const K &key) {
+  auto maybe = find(key);
+  if (!maybe)
+    throw std::out_of_range("HashMap::at : the given key is not in the map");
+  return *maybe;
+}
+
+template <class K, class V, class H, bool C>
+void HashMap<K, V, H, C>::erase(const K &key) {
+  this->_erase(key);
+}
+
+template <class K, class V, class H, bool C>
+template <class Lookup, class>
+void HashMap<K, V, H, C>::erase(const Lookup &key) {
+  this->_erase(key);
+}
+
+template <class K, class V, class H, bool C>
+typename HashMap<K, V, H, C>::template Maybe<const V>
+HashMap<K, V, H, C>::find(const K &key) const {
+  return const_cast<HashMap<K, V, H, C> *>(this)->find(key);
+}
+
+template <class K, class V, class H, bool C>
+typename HashMap<K, V, H, C>::template Maybe<V>
+HashMap<K, V, H, C>::find(const K &key) {
+  value_type *pair = this->_find(key);
+  return Maybe<V>(pair ? &pair->second : nullptr);
+}
+
+template <class K, class V, class H, bool C>
+bool HashMap<K, V, H, C>::contains(const K &key) const {
+  return find(key);
+}
+
+template <class K, class V, class H, bool C>
+template <class Lookup, class>
+typename HashMap<K, V, H, C>::template Maybe<const V>
+HashMap<K, V, H, C>::find(const Lookup &key) const {
+  return const_cast<HashMap<K, V, H, C> *>(this)->find(key);
+}
+
+template <class K, class V, class H, bool C>
+template <class Lookup, class>
+typename HashMap<K, V, H, C>::template Maybe<V>
+HashMap<K, V, H, C>::find(const Lookup &key) {
+  value_type *pair = this->_find(key);
+  return Maybe<V>(pair ? &pair->second : nullptr);
+}
+
+template <class K, class V, class H, bool C>
+template <class Lookup, class>
+bool HashMap<K, V, H, C>::contains(const Lookup &key) const {
+  return find(key);
+}
+
+template <class K, class V, class H, bool C>
+template <class Key, class... Args>
+std::pair<typename HashMap<K, V, H, C>::template Maybe<V>, bool>
+HashMap<K, V, H, C>::_try_emplace(Key &&key, Args &&... args) {
+  std::size_t h = this->_hash(key);
+  if (value_type *pair = this->_find(key, h))
+    return {Maybe<V>(&pair->second), false};
+
+  value_type &pair =
+      this->_insert(h, std::piecewise_construct,
+                    std::forward_as_tuple(std::forward<Key>(key)),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+  return {Maybe<V>(&pair.second), true};
+}
+
+template <class K, class V, class H, bool C>
+template <class Key, class M>
+std::pair<typename HashMap<K, V, H, C>::template Maybe<V>, bool>
+HashMap<K, V, H, C>::_insert_or_assign(Key &&key, M &&value) {
+  std::size_t h = this->_hash(key);
+  if (value_type *pair = this->_find(key, h)) {
+    pair->second = std::forward<M>(value);
+    return {Maybe<V>(&pair->second), false};
+  }
+
+  value_type &pair =
+      this->_insert(h, std::forward<Key>(key), std::forward<M>(value));
+  return {Maybe<V>(&pair.second), true};
+}
+
+#endif // GUARD_HASH_MAP_HPP__
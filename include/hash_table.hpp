@@ -2,63 +2,70 @@
 #define GUARD_HASH_TABLE_HPP__
 
 #include "details/hash.hpp"
-#include "single_linked_list.hpp"
+#include "details/hash_table_base.hpp"
+#include "details/maybe.hpp"
+#include "details/seeded_hash.hpp"
 #include <initializer_list>
+#include <iterator>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <utility>
 
-template <class Type, class HashFunctor = hash<Type>> struct HashTable {
+template <class Type, class HashFunctor, bool CacheHash>
+struct ShardedHashTable;
+
+// CacheHash selects whether the hash of each element is stored next to it
+template <class Type, class HashFunctor = hash<Type>,
+          bool CacheHash = details::cache_hash_by_default<Type>::value>
+struct HashTable : details::HashTableBase<Type, Type, details::identity,
+                                          HashFunctor, CacheHash> {
   // Constructs an empty hash table
-  HashTable();
+  HashTable() = default;
+  // Constructs an empty hash table hashing with a copy of the given functor
+  explicit HashTable(const HashFunctor &hasher)
+      : details::HashTableBase<Type, Type, details::identity, HashFunctor,
+                               CacheHash>(hasher) {}
   // Constructs a hash table initialized with the list of parameters
   HashTable(const std::initializer_list<Type> &);
-  HashTable(const HashTable &);
-  HashTable(HashTable &&);
-
-  ~HashTable();
+  HashTable(const HashTable &) = default;
+  HashTable(HashTable &&) = default;
 
   // Insert a new value into the table
+  // Throw a std::runtime_error if the value is already in the table
   void insert(const Type &);
+  void insert(Type &&);
+
+  // Insert a new value constructed in place from the arguments
+  // Throw a std::runtime_error if the value is already in the table
+  template <class... Args> void emplace(Args &&...);
+
+  // Structure that may contain a value or not
+  template <class T> using Maybe = details::Maybe<T>;
+
+  // Insert the value if it is not in the table yet, otherwise do nothing. An
+  // argument that is not inserted is not moved from.
+  // Return the element of the table equal to the value, and true if it was
+  // inserted. Never throws on duplicates, which makes it the preferred way to
+  // insert values that may already be present.
+  std::pair<Maybe<Type>, bool> try_insert(const Type &);
+  std::pair<Maybe<Type>, bool> try_insert(Type &&);
+  // Same as try_insert, with the value constructed in place from the
+  // arguments. The value is built even if it is then found in the table.
+  template <class... Args>
+  std::pair<Maybe<Type>, bool> try_emplace(Args &&...);
 
   // Remove the given value from the table
   void erase(const Type &);
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  void erase(const K &);
 
   // Return the value matching the argument.
-  // Throw a std::runtime_error if the value is not in the table
+  // Throw a std::out_of_range if the value is not in the table
   Type operator[](const Type &) const;
   Type &operator[](const Type &);
 
-  std::size_t size() const { return _size; }
-
-private:
-  std::size_t _size, _capacity;
-  SingleLinkedList<Type> *_storage;
-
-  void _resize();
-  SingleLinkedList<Type> &_store_for(const Type &);
-  const SingleLinkedList<Type> &_store_for(const Type &) const;
-
-public:
-  // Structure that may contain a value or not
-  template <class T> struct Maybe {
-    constexpr Maybe(T * = nullptr);
-    template <class U> constexpr Maybe(const Maybe<U> &);
-
-    // Return the contained value if it exists. Throw otherwise
-    const T &operator*() const;
-    const T *operator->() const;
-    T &operator*();
-    T *operator->();
-
-    // Evaluate to true a value is contained, false otherwise
-    operator bool() const;
-
-  private:
-    friend Maybe<std::add_const_t<T>>;
-    T *_pointer;
-  };
-
   // Returns a dereferenceable structure that may contain the searched value
   // Implicitely convertible to bool with true value if the searched value is
   // contained, false value if the value is not contained
@@ -67,189 +74,215 @@ public:
 
   // Return true if the value is in the table, false otherwise
   bool contains(const Type &) const;
+
+  // Lookups with a different type than the stored one, available if the hash
+  // functor is transparent (as hash<std::string> is). A table of strings can
+  // then be searched with string views or C strings without allocation.
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  Maybe<const Type> find(const K &) const;
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  Maybe<Type> find(const K &);
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  bool contains(const K &) const;
+
+  // Batched operations over a range of values. The values are hashed and
+  // their buckets prefetched ahead of the lookups, which is faster than
+  // calling the single value operations in a loop on large tables.
+
+  // Write the result of find for each value of the range to the output
+  // iterator, and return the output iterator past the last written result
+  template <class InputIt, class OutputIt>
+  OutputIt find_many(InputIt, InputIt, OutputIt) const;
+  template <class InputIt, class OutputIt>
+  OutputIt find_many(InputIt, InputIt, OutputIt);
+
+  // Write the result of contains for each value of the range to the output
+  // iterator, and return the output iterator past the last written result
+  template <class InputIt, class OutputIt>
+  OutputIt contains_many(InputIt, InputIt, OutputIt) const;
+
+  // Insert every value of the range
+  // Throw a std::runtime_error when reaching a value that is already in the
+  // table, the values preceding it stay inserted
+  template <class InputIt> void insert_many(InputIt, InputIt);
+
+private:
+  // Inserts values hashed beforehand in its shards
+  friend struct ShardedHashTable<Type, HashFunctor, CacheHash>;
 };
 
-template <class T, class H>
-HashTable<T, H>::HashTable()
-    : _size(0), _capacity(2), _storage(new SingleLinkedList<T>[2]) {}
-
-template <class T, class H>
-HashTable<T, H>::HashTable(const std::initializer_list<T> &list)
-    : _size(0), _capacity(2), _storage(new SingleLinkedList<T>[_capacity]) {
-  try {
-    for (const auto &e : list) {
-      insert(e);
-    }
-  } catch (...) {
-    delete[] _storage;
-    throw;
+template <class T, class H, bool C>
+HashTable<T, H, C>::HashTable(const std::initializer_list<T> &list) {
+  for (const auto &e : list) {
+    insert(e);
   }
 }
 
-template <class T, class H>
-HashTable<T, H>::HashTable(const HashTable<T, H> &h)
-    : _size(0), _capacity(h._capacity),
-      _storage(new SingleLinkedList<T>[_capacity] {}) {
-  try {
-    for (std::size_t i = 0; i < h._capacity; ++i) {
-      for (const auto &v : h._storage[i]) {
-        insert(v);
-      }
-    }
-  } catch (...) {
-    delete[] _storage;
-    throw;
-  }
+template <class T, class H, bool C>
+void HashTable<T, H, C>::insert(const T &val) {
+  if (!try_insert(val).second)
+    throw std::runtime_error("HashTable insertion error: an element with the "
+                             "same value exists already");
 }
 
-template <class T, class H>
-HashTable<T, H>::HashTable(HashTable<T, H> &&h)
-    : _size(std::exchange(h._size, 0)),
-      _capacity(std::exchange(h._capacity, 2)),
-      _storage(std::exchange(h._storage, new SingleLinkedList<T>[2])) {}
-
-template <class T, class H> void HashTable<T, H>::insert(const T &val) {
-  // Hash the value then find the associated address
-  std::size_t h = H()(val);
-  std::size_t pos = h % _capacity;
-  SingleLinkedList<T> &store = _storage[pos];
-
-  // Throw if the value is already in the table
-  for (auto it = store.begin(); it != store.end(); ++it)
-    if (*it == val)
-      throw std::runtime_error("HashTable insertion error: an element with the "
-                               "same value exists already");
-  _size++;
-
-  // Resize and adjust the position if needed
-  // note that the comparison is completely arbitrary, benchmarking would be
-  // required to determine the optimal point at which the array needs resizing
-  if (_size >= _capacity) {
-    _resize();
-    pos = h % _capacity;
-  }
-
-  // Push in the list at the right position, done
-  _storage[pos].push_front(val);
+template <class T, class H, bool C> void HashTable<T, H, C>::insert(T &&val) {
+  if (!try_insert(std::move(val)).second)
+    throw std::runtime_error("HashTable insertion error: an element with the "
+                             "same value exists already");
 }
 
-template <class T, class H> void HashTable<T, H>::erase(const T &val) {
-  SingleLinkedList<T> &store = _store_for(val);
-
-  auto it = store.find(val);
-  if (it != store.end()) {
-    store.erase(it);
-    --_size;
-  }
+template <class T, class H, bool C>
+template <class... Args>
+void HashTable<T, H, C>::emplace(Args &&... args) {
+  if (!try_emplace(std::forward<Args>(args)...).second)
+    throw std::runtime_error("HashTable insertion error: an element with the "
+                             "same value exists already");
 }
 
-template <class T, class H>
-typename HashTable<T, H>::template Maybe<const T>
-HashTable<T, H>::find(const T &value) const {
-  return const_cast<HashTable<T, H> *>(this)->find(value);
+template <class T, class H, bool C>
+std::pair<typename HashTable<T, H, C>::template Maybe<T>, bool>
+HashTable<T, H, C>::try_insert(const T &val) {
+  // Hash the value once for both the lookup and the insertion
+  std::size_t h = this->_hash(val);
+  if (T *existing = this->_find(val, h))
+    return {Maybe<T>(existing), false};
+  return {Maybe<T>(&this->_insert(h, val)), true};
 }
 
-template <class T, class H>
-typename HashTable<T, H>::template Maybe<T>
-HashTable<T, H>::find(const T &value) {
-  auto &store = _store_for(value);
-  auto it = store.find(value);
-  return Maybe<T>(it == store.end() ? nullptr : &*it);
+template <class T, class H, bool C>
+std::pair<typename HashTable<T, H, C>::template Maybe<T>, bool>
+HashTable<T, H, C>::try_insert(T &&val) {
+  std::size_t h = this->_hash(val);
+  if (T *existing = this->_find(val, h))
+    return {Maybe<T>(existing), false};
+  return {Maybe<T>(&this->_insert(h, std::move(val))), true};
 }
 
-template <class T, class H> T HashTable<T, H>::operator[](const T &val) const {
-  return const_cast<HashTable<T, H> *>(this)->operator[](val);
+template <class T, class H, bool C>
+template <class... Args>
+std::pair<typename HashTable<T, H, C>::template Maybe<T>, bool>
+HashTable<T, H, C>::try_emplace(Args &&... args) {
+  auto result = this->_emplace(std::forward<Args>(args)...);
+  return {Maybe<T>(result.first), result.second};
 }
 
-template <class T, class H> T &HashTable<T, H>::operator[](const T &value) {
-  auto maybe = find(value);
-  if (!maybe)
-    throw std::out_of_range(
-        "HashTable::operator[] : the given key is not in the table");
-  return *maybe;
+template <class T, class H, bool C>
+void HashTable<T, H, C>::erase(const T &val) {
+  this->_erase(val);
 }
 
-template <class T, class H>
-bool HashTable<T, H>::contains(const T &value) const {
-  return find(value);
+template <class T, class H, bool C>
+template <class K, class>
+void HashTable<T, H, C>::erase(const K &key) {
+  this->_erase(key);
 }
 
-template <class T, class H> HashTable<T, H>::~HashTable() { delete[] _storage; }
-
-template <class T, class H> void HashTable<T, H>::_resize() {
-
-  std::size_t old_capacity = _capacity;
-  _capacity *= 2; // arbitrary and most likely inefficient
+template <class T, class H, bool C>
+typename HashTable<T, H, C>::template Maybe<const T>
+HashTable<T, H, C>::find(const T &value) const {
+  return const_cast<HashTable<T, H, C> *>(this)->find(value);
+}
 
-  SingleLinkedList<T> *new_array = new SingleLinkedList<T>[_capacity];
-  // recalculate every position of the existing elements, then insert them in
-  // the new array
-  for (std::size_t i = 0; i < old_capacity; ++i) {
-    for (auto it = _storage[i].begin(); it != _storage[i].end(); ++it) {
-      new_array[H()(*it) % _capacity].push_front(*it);
-    }
-  }
+template <class T, class H, bool C>
+typename HashTable<T, H, C>::template Maybe<T>
+HashTable<T, H, C>::find(const T &value) {
+  return Maybe<T>(this->_find(value));
+}
 
-  std::swap(new_array, _storage);
-  delete[] new_array;
+template <class T, class H, bool C>
+template <class K, class>
+typename HashTable<T, H, C>::template Maybe<const T>
+HashTable<T, H, C>::find(const K &key) const {
+  return const_cast<HashTable<T, H, C> *>(this)->find(key);
 }
 
-template <class Type, class H>
-SingleLinkedList<Type> &HashTable<Type, H>::_store_for(const Type &val) {
-  std::size_t h = H()(val);
-  std::size_t pos = h % _capacity;
-  return _storage[pos];
+template <class T, class H, bool C>
+template <class K, class>
+typename HashTable<T, H, C>::template Maybe<T>
+HashTable<T, H, C>::find(const K &key) {
+  return Maybe<T>(this->_find(key));
 }
 
-template <class Type, class H>
-const SingleLinkedList<Type> &
-HashTable<Type, H>::_store_for(const Type &val) const {
-  return const_cast<HashTable<Type, H> *>(this)->_store_for(val);
+template <class T, class H, bool C>
+T HashTable<T, H, C>::operator[](const T &val) const {
+  return const_cast<HashTable<T, H, C> *>(this)->operator[](val);
 }
 
-template <class Type, class H>
-template <class T>
-constexpr HashTable<Type, H>::Maybe<T>::Maybe(T *pointer) : _pointer(pointer) {}
+template <class T, class H, bool C>
+T &HashTable<T, H, C>::operator[](const T &value) {
+  auto maybe = find(value);
+  if (!maybe)
+    throw std::out_of_range(
+        "HashTable::operator[] : the given key is not in the table");
+  return *maybe;
+}
 
-template <class Type, class H>
-template <class T>
-template <class U>
-constexpr HashTable<Type, H>::Maybe<T>::Maybe(const Maybe<U> &mb)
-    : _pointer(mb._pointer) {}
+template <class T, class H, bool C>
+bool HashTable<T, H, C>::contains(const T &value) const {
+  return find(value);
+}
 
-template <class Type, class H>
-template <class T>
-const T &HashTable<Type, H>::Maybe<T>::operator*() const {
-  return const_cast<Maybe<T> *>(this)->operator*();
+template <class T, class H, bool C>
+template <class K, class>
+bool HashTable<T, H, C>::contains(const K &key) const {
+  return find(key);
 }
 
-template <class Type, class H>
-template <class T>
-const T *HashTable<Type, H>::Maybe<T>::operator->() const {
-  return const_cast<Maybe<T> *>(this)->operator();
+template <class T, class H, bool C>
+template <class InputIt, class OutputIt>
+OutputIt HashTable<T, H, C>::find_many(InputIt first, InputIt last,
+                                       OutputIt out) const {
+  auto self = const_cast<HashTable<T, H, C> *>(this);
+  self->_for_each_hashed(first, last,
+                         [self, &out](const auto &key, std::size_t h) {
+                           *out++ = Maybe<const T>(self->_find(key, h));
+                         });
+  return out;
 }
 
-template <class Type, class H>
-template <class T>
-T &HashTable<Type, H>::Maybe<T>::operator*() {
-  if (!_pointer)
-    throw std::runtime_error(
-        "HashTable::Maybe error: dereferencing null pointer");
-  return *_pointer;
+template <class T, class H, bool C>
+template <class InputIt, class OutputIt>
+OutputIt HashTable<T, H, C>::find_many(InputIt first, InputIt last,
+                                       OutputIt out) {
+  this->_for_each_hashed(first, last,
+                         [this, &out](const auto &key, std::size_t h) {
+                           *out++ = Maybe<T>(this->_find(key, h));
+                         });
+  return out;
 }
 
-template <class Type, class H>
-template <class T>
-T *HashTable<Type, H>::Maybe<T>::operator->() {
-  return _pointer ? _pointer
-                  : throw std::runtime_error(
-                        "HashTable::Maybe error: dereferencing null pointer");
+template <class T, class H, bool C>
+template <class InputIt, class OutputIt>
+OutputIt HashTable<T, H, C>::contains_many(InputIt first, InputIt last,
+                                           OutputIt out) const {
+  auto self = const_cast<HashTable<T, H, C> *>(this);
+  self->_for_each_hashed(first, last,
+                         [self, &out](const auto &key, std::size_t h) {
+                           *out++ = self->_find(key, h) != nullptr;
+                         });
+  return out;
 }
 
-template <class Type, class H>
-template <class T>
-HashTable<Type, H>::Maybe<T>::operator bool() const {
-  return _pointer;
+template <class T, class H, bool C>
+template <class InputIt>
+void HashTable<T, H, C>::insert_many(InputIt first, InputIt last) {
+  // Grow once up front rather than during the insertions, which would also
+  // make the prefetched buckets useless
+  if constexpr (std::is_base_of<std::forward_iterator_tag,
+                                typename std::iterator_traits<
+                                    InputIt>::iterator_category>::value)
+    this->reserve(this->size() +
+                  static_cast<std::size_t>(std::distance(first, last)));
+
+  this->_for_each_hashed(first, last, [this](const T &val, std::size_t h) {
+    if (this->_find(val, h))
+      throw std::runtime_error("HashTable insertion error: an element with "
+                               "the same value exists already");
+    this->_insert(h, val);
+  });
 }
 
 #endif // GUARD_HASH_TABLE_HPP__
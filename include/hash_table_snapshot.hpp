@@ -0,0 +1,215 @@
+#ifndef GUARD_HASH_TABLE_SNAPSHOT_HPP__
+#define GUARD_HASH_TABLE_SNAPSHOT_HPP__
+
+#include "details/hash.hpp"
+#include "details/mapped_file.hpp"
+#include "hash_table.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// Read-only hash table of strings stored in a file, for large tables that
+// would take long to rebuild on every start. The file is mapped in memory and
+// searched in place: opening a snapshot costs the same whatever its size, and
+// processes opening the same file share its pages through the page cache.
+//
+// The file holds no pointer, every position is an offset from its start:
+//   header      magic number, byte order, character size, size, bucket count
+//   buckets     bucket_count + 1 indices of records, the records of bucket i
+//               are the ones from buckets[i] to buckets[i + 1] excluded
+//   records     hash of the string, offset of its characters and length
+//   characters  the strings one after the other
+// Integers are in the byte order of the machine that wrote the file, which is
+// checked when opening it. The hash functor must give the same results in the
+// processes writing and reading the file, and accept string views.
+template <class CharT = char,
+          class HashFunctor = hash<std::basic_string<CharT>>>
+struct HashTableSnapshot {
+  typedef std::basic_string<CharT> string_type;
+  typedef std::basic_string_view<CharT> view_type;
+
+  // Write the content of the table to the file at the given path, replacing
+  // it if it exists. The snapshot is written to a temporary file of the same
+  // directory then renamed, a process opening the path never sees a partial
+  // snapshot and the snapshots already mapped keep their content.
+  // Throw a std::runtime_error if the file cannot be written
+  template <bool CacheHash>
+  static void write(const HashTable<string_type, HashFunctor, CacheHash> &,
+                    const std::string &);
+
+  // Map the snapshot stored at the given path
+  // Throw a std::runtime_error if the file cannot be mapped or is not a
+  // snapshot of strings of CharT written on a machine of the same byte order
+  explicit HashTableSnapshot(const std::string &);
+  // The moved-from snapshot can only be destroyed
+  HashTableSnapshot(HashTableSnapshot &&) = default;
+
+  std::size_t size() const { return _header().size; }
+  std::size_t bucket_count() const { return _header().bucket_count; }
+
+  // Return a view of the string equal to the argument, pointing into the
+  // mapped file, if it is in the snapshot
+  std::optional<view_type> find(view_type) const;
+
+  // Return true if the string is in the snapshot, false otherwise
+  bool contains(view_type) const;
+
+private:
+  struct Header {
+    char magic[8];
+    std::uint32_t byte_order;
+    std::uint32_t char_size;
+    std::uint64_t size, bucket_count;
+  };
+  struct Record {
+    std::uint64_t hash, offset, length;
+  };
+
+  static constexpr char _magic[8] = {'H', 'T', 'S', 'N', 'A', 'P', '0', '1'};
+  static constexpr std::uint32_t _byte_order = 0x01020304;
+
+  details::MappedFile _file;
+
+  const Header &_header() const {
+    return *reinterpret_cast<const Header *>(_file.data());
+  }
+  const std::uint64_t *_buckets() const {
+    return reinterpret_cast<const std::uint64_t *>(_file.data() +
+                                                   sizeof(Header));
+  }
+  const Record *_records() const {
+    return reinterpret_cast<const Record *>(_buckets() + bucket_count() + 1);
+  }
+
+  [[noreturn]] static void _corrupted() {
+    throw std::runtime_error(
+        "HashTableSnapshot error: the file is not a valid snapshot");
+  }
+};
+
+template <class C, class H>
+template <bool CacheHash>
+void HashTableSnapshot<C, H>::write(
+    const HashTable<string_type, H, CacheHash> &table,
+    const std::string &path) {
+  struct Entry {
+    std::uint64_t hash, bucket;
+    const string_type *value;
+  };
+  std::uint64_t bucket_count = details::next_power_of_2(table.size());
+  std::vector<Entry> entries;
+  entries.reserve(table.size());
+  table.for_each([&entries, bucket_count](const string_type &s) {
+    std::uint64_t h = H()(view_type(s));
+    entries.push_back({h, details::mix_hash(h) & (bucket_count - 1), &s});
+  });
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const Entry &a, const Entry &b) {
+                     return a.bucket < b.bucket;
+                   });
+
+  Header header{{}, _byte_order, sizeof(C), entries.size(), bucket_count};
+  std::memcpy(header.magic, _magic, sizeof(_magic));
+
+  std::vector<std::uint64_t> buckets(bucket_count + 1, 0);
+  for (const Entry &e : entries)
+    ++buckets[e.bucket + 1];
+  for (std::size_t b = 0; b < bucket_count; ++b)
+    buckets[b + 1] += buckets[b];
+
+  // Characters start right after the records, which keeps them aligned
+  std::uint64_t offset = sizeof(Header) +
+                         buckets.size() * sizeof(std::uint64_t) +
+                         entries.size() * sizeof(Record);
+  std::vector<Record> records;
+  records.reserve(entries.size());
+  for (const Entry &e : entries) {
+    records.push_back({e.hash, offset, e.value->size()});
+    offset += e.value->size() * sizeof(C);
+  }
+
+  // Random suffix, for concurrent writers of the same path
+  std::string temporary =
+      path + ".tmp" + std::to_string(std::random_device()());
+  std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(buckets.data()),
+            buckets.size() * sizeof(std::uint64_t));
+  out.write(reinterpret_cast<const char *>(records.data()),
+            records.size() * sizeof(Record));
+  for (const Entry &e : entries)
+    out.write(reinterpret_cast<const char *>(e.value->data()),
+              e.value->size() * sizeof(C));
+  // The state keeps the errors of every write, of the flush and of the close
+  out.flush();
+  out.close();
+  std::error_code error;
+  // Replaces the file if it exists, on Windows as well
+  if (out)
+    std::filesystem::rename(temporary, path, error);
+  if (!out || error) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("HashTableSnapshot error: cannot write " + path);
+  }
+}
+
+template <class C, class H>
+HashTableSnapshot<C, H>::HashTableSnapshot(const std::string &path)
+    : _file(path) {
+  // Only the fixed parts are checked here, the records are checked when read
+  if (_file.size() < sizeof(Header))
+    _corrupted();
+  const Header &header = _header();
+  if (std::memcmp(header.magic, _magic, sizeof(_magic)) != 0 ||
+      header.byte_order != _byte_order || header.char_size != sizeof(C))
+    throw std::runtime_error("HashTableSnapshot error: " + path +
+                             " is not a snapshot of this type of strings");
+  std::uint64_t records_end =
+      sizeof(Header) + (header.bucket_count + 1) * sizeof(std::uint64_t) +
+      header.size * sizeof(Record);
+  if (header.bucket_count == 0 ||
+      (header.bucket_count & (header.bucket_count - 1)) != 0 ||
+      header.bucket_count > _file.size() || header.size > _file.size() ||
+      records_end > _file.size())
+    _corrupted();
+}
+
+template <class C, class H>
+std::optional<typename HashTableSnapshot<C, H>::view_type>
+HashTableSnapshot<C, H>::find(view_type key) const {
+  std::uint64_t h = H()(key);
+  std::size_t b = details::mix_hash(h) & (bucket_count() - 1);
+  std::uint64_t first = _buckets()[b], last = _buckets()[b + 1];
+  if (first > last || last > size())
+    _corrupted();
+
+  for (const Record *r = _records() + first; r != _records() + last; ++r) {
+    if (r->hash != h || r->length != key.size())
+      continue;
+    if (r->offset > _file.size() ||
+        r->length > (_file.size() - r->offset) / sizeof(C))
+      _corrupted();
+    view_type candidate(reinterpret_cast<const C *>(_file.data() + r->offset),
+                        r->length);
+    if (candidate == key)
+      return candidate;
+  }
+  return std::nullopt;
+}
+
+template <class C, class H>
+bool HashTableSnapshot<C, H>::contains(view_type key) const {
+  return find(key).has_value();
+}
+
+#endif // GUARD_HASH_TABLE_SNAPSHOT_HPP__
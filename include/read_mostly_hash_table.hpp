@@ -0,0 +1,233 @@
+#ifndef GUARD_READ_MOSTLY_HASH_TABLE_HPP__
+#define GUARD_READ_MOSTLY_HASH_TABLE_HPP__
+
+#include "details/hash.hpp"
+#include "hash_table.hpp"
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+// Hash table for data read by many threads and rarely modified, such as
+// configuration or routing tables. Readers never take a lock: they search an
+// immutable version of the table, published through an atomic pointer.
+// Writers are serialized by a mutex, copy the current version, modify the copy
+// and publish it in place of the current one.
+//
+// The replaced versions are reclaimed by epochs. A reader registers in the
+// current epoch, on a counter chosen among a set of cache line sized slots
+// after its thread, so that threads reading in parallel rarely share a counter.
+// After publishing a version, the writer moves to the next epoch and waits for
+// the counters of the previous epoch to drop to 0 before freeing the replaced
+// version: the readers that may still hold it are all registered in that
+// epoch.
+//
+// Every modification copies the whole table, modifications should be grouped
+// with update whenever possible.
+template <class Type, class HashFunctor = hash<Type>,
+          bool CacheHash = details::cache_hash_by_default<Type>::value>
+struct ReadMostlyHashTable {
+  typedef HashTable<Type, HashFunctor, CacheHash> table_type;
+
+  // Constructs an empty hash table
+  ReadMostlyHashTable();
+  // Constructs a hash table initialized with the list of parameters
+  ReadMostlyHashTable(const std::initializer_list<Type> &);
+  ReadMostlyHashTable(const ReadMostlyHashTable &) = delete;
+  ReadMostlyHashTable &operator=(const ReadMostlyHashTable &) = delete;
+
+  // No thread may read or modify the table during its destruction
+  ~ReadMostlyHashTable();
+
+  // Consistent read-only view of the table. The version seen by a snapshot is
+  // not freed before the snapshot is destroyed, and writers wait for it after
+  // publishing a new version: a thread holding a snapshot must not modify the
+  // table, and snapshots should be short lived.
+  struct Snapshot {
+    Snapshot(Snapshot &&s)
+        : _counter(std::exchange(s._counter, nullptr)), _table(s._table) {}
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+    ~Snapshot() {
+      if (_counter)
+        _counter->fetch_sub(1);
+    }
+
+    const table_type &operator*() const { return *_table; }
+    const table_type *operator->() const { return _table; }
+
+  private:
+    friend struct ReadMostlyHashTable;
+    Snapshot(std::atomic<std::size_t> *counter, const table_type *table)
+        : _counter(counter), _table(table) {}
+
+    std::atomic<std::size_t> *_counter;
+    const table_type *_table;
+  };
+
+  // Return a view of the current version of the table
+  Snapshot snapshot() const;
+
+  // Return a copy of the value matching the argument if it is in the table.
+  // Unlike the other tables, find cannot return a Maybe: the version holding
+  // the value may be freed by a writer as soon as find returns. Use a snapshot
+  // to read values in place.
+  std::optional<Type> find(const Type &) const;
+
+  // Return true if the value is in the table, false otherwise
+  bool contains(const Type &value) const {
+    return snapshot()->contains(value);
+  }
+
+  // Lookups with a different type than the stored one, available if the hash
+  // functor is transparent
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  std::optional<Type> find(const K &) const;
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  bool contains(const K &key) const {
+    return snapshot()->contains(key);
+  }
+
+  std::size_t size() const { return snapshot()->size(); }
+
+  // Insert a new value into the table
+  // Throw a std::runtime_error if the value is already in the table
+  void insert(const Type &);
+
+  // Remove the given value from the table
+  void erase(const Type &);
+
+  // Call the function on a copy of the current version of the table, then
+  // publish the copy. Readers see either none or all of the modifications.
+  // If the function throws, the table is left unchanged.
+  template <class F> void update(F);
+
+private:
+  struct alignas(64) ReaderSlot {
+    // Number of readers of the even and of the odd epochs
+    std::atomic<std::size_t> readers[2] = {};
+  };
+  static constexpr std::size_t _slot_count = 64;
+
+  mutable ReaderSlot _slots[_slot_count];
+  std::atomic<std::size_t> _epoch;
+  std::atomic<const table_type *> _current;
+  // Held by the writers
+  std::mutex _write_mutex;
+
+  // Register the calling thread as a reader of the current epoch and return
+  // the counter to decrement when it is done
+  std::atomic<std::size_t> &_enter() const;
+  // Replace the current version by the given one and free the former once no
+  // reader can hold it anymore. The write mutex must be held
+  void _publish(std::unique_ptr<table_type>);
+};
+
+template <class T, class H, bool C>
+ReadMostlyHashTable<T, H, C>::ReadMostlyHashTable()
+    : _epoch(0), _current(new table_type) {}
+
+template <class T, class H, bool C>
+ReadMostlyHashTable<T, H, C>::ReadMostlyHashTable(
+    const std::initializer_list<T> &list)
+    : _epoch(0), _current(new table_type(list)) {}
+
+template <class T, class H, bool C>
+ReadMostlyHashTable<T, H, C>::~ReadMostlyHashTable() {
+  delete _current.load();
+}
+
+template <class T, class H, bool C>
+std::atomic<std::size_t> &ReadMostlyHashTable<T, H, C>::_enter() const {
+  static thread_local const std::size_t slot =
+      details::mix_hash(std::hash<std::thread::id>()(
+          std::this_thread::get_id())) &
+      (_slot_count - 1);
+  // If the epoch changes between its reading and the registration, the writer
+  // may have missed the registration: register again in the new epoch
+  for (;;) {
+    std::size_t epoch = _epoch.load();
+    std::atomic<std::size_t> &counter = _slots[slot].readers[epoch & 1];
+    counter.fetch_add(1);
+    if (_epoch.load() == epoch)
+      return counter;
+    counter.fetch_sub(1);
+  }
+}
+
+template <class T, class H, bool C>
+typename ReadMostlyHashTable<T, H, C>::Snapshot
+ReadMostlyHashTable<T, H, C>::snapshot() const {
+  std::atomic<std::size_t> &counter = _enter();
+  return Snapshot(&counter, _current.load());
+}
+
+template <class T, class H, bool C>
+std::optional<T> ReadMostlyHashTable<T, H, C>::find(const T &value) const {
+  Snapshot s = snapshot();
+  auto found = s->find(value);
+  return found ? std::optional<T>(*found) : std::nullopt;
+}
+
+template <class T, class H, bool C>
+template <class K, class>
+std::optional<T> ReadMostlyHashTable<T, H, C>::find(const K &key) const {
+  Snapshot s = snapshot();
+  auto found = s->find(key);
+  return found ? std::optional<T>(*found) : std::nullopt;
+}
+
+template <class T, class H, bool C>
+void ReadMostlyHashTable<T, H, C>::insert(const T &value) {
+  std::lock_guard<std::mutex> lock(_write_mutex);
+  // Writers own the current version, it can be read without registering
+  const table_type *current = _current.load();
+  if (current->contains(value))
+    throw std::runtime_error("HashTable insertion error: an element with the "
+                             "same value exists already");
+  auto copy = std::make_unique<table_type>(*current);
+  copy->insert(value);
+  _publish(std::move(copy));
+}
+
+template <class T, class H, bool C>
+void ReadMostlyHashTable<T, H, C>::erase(const T &value) {
+  std::lock_guard<std::mutex> lock(_write_mutex);
+  const table_type *current = _current.load();
+  if (!current->contains(value))
+    return;
+  auto copy = std::make_unique<table_type>(*current);
+  copy->erase(value);
+  _publish(std::move(copy));
+}
+
+template <class T, class H, bool C>
+template <class F>
+void ReadMostlyHashTable<T, H, C>::update(F f) {
+  std::lock_guard<std::mutex> lock(_write_mutex);
+  auto copy = std::make_unique<table_type>(*_current.load());
+  f(*copy);
+  _publish(std::move(copy));
+}
+
+template <class T, class H, bool C>
+void ReadMostlyHashTable<T, H, C>::_publish(std::unique_ptr<table_type> t) {
+  std::unique_ptr<const table_type> old(_current.exchange(t.release()));
+
+  // Readers registered from now on see the new version. The ones registered
+  // in the previous epoch may hold the old one, and the ones of the epoch
+  // before have been waited for by the previous writer.
+  std::size_t epoch = _epoch.fetch_add(1);
+  for (ReaderSlot &slot : _slots)
+    while (slot.readers[epoch & 1].load() != 0)
+      std::this_thread::yield();
+}
+
+#endif // GUARD_READ_MOSTLY_HASH_TABLE_HPP__
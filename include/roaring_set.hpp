@@ -0,0 +1,578 @@
+#ifndef GUARD_ROARING_SET_HPP__
+#define GUARD_ROARING_SET_HPP__
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace details {
+// Number of bits set
+inline unsigned popcount(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+  x -= (x >> 1) & 0x5555555555555555ull;
+  x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+  x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0full;
+  return static_cast<unsigned>((x * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+// Position of the lowest bit set, x must not be 0
+inline unsigned count_trailing_zeros(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long i;
+  _BitScanForward64(&i, x);
+  return static_cast<unsigned>(i);
+#else
+  unsigned i = 0;
+  for (; !(x & 1); x >>= 1)
+    ++i;
+  return i;
+#endif
+}
+
+// Set of the 65536 values of the low 16 bits of a chunk of a RoaringSet,
+// stored in the most compact of three forms:
+//  - a sorted array of values, for up to 4096 values (8KB)
+//  - a bitmap of 65536 bits (8KB), for more values
+//  - a sorted array of runs of consecutive values, only built by optimize,
+//    and expanded back to another form before being modified
+struct RoaringContainer {
+  enum Kind : std::uint8_t { array, bitmap, runs };
+
+  static constexpr std::uint32_t max_array_size = 4096;
+  static constexpr std::size_t bitmap_words = 1024;
+
+  Kind kind = array;
+  std::uint32_t cardinality = 0;
+  // Sorted values of an array, or first value and length - 1 of each run
+  std::vector<std::uint16_t> values;
+  // Bits of a bitmap
+  std::vector<std::uint64_t> words;
+
+  bool contains(std::uint16_t) const;
+  // Return true if the value was not in the container
+  bool insert(std::uint16_t);
+  // Return true if the value was in the container
+  bool erase(std::uint16_t);
+
+  // Call the function on every value, in increasing order
+  template <class F> void for_each(F) const;
+
+  // Switch to the most compact form
+  void optimize();
+  std::size_t memory_usage() const {
+    return sizeof(*this) + values.capacity() * sizeof(std::uint16_t) +
+           words.capacity() * sizeof(std::uint64_t);
+  }
+
+  static RoaringContainer unite(const RoaringContainer &,
+                                const RoaringContainer &);
+  static RoaringContainer intersect(const RoaringContainer &,
+                                    const RoaringContainer &);
+
+private:
+  // Move to the array or the bitmap form depending on the cardinality
+  void _normalize();
+  void _to_bitmap();
+  void _to_array();
+  // Replace runs by an array or a bitmap
+  void _expand();
+  void _count_bits();
+  bool _test(std::uint16_t v) const {
+    return (words[v >> 6] >> (v & 63)) & 1;
+  }
+  void _set(std::uint16_t v) {
+    words[v >> 6] |= std::uint64_t(1) << (v & 63);
+  }
+};
+
+inline bool RoaringContainer::contains(std::uint16_t v) const {
+  switch (kind) {
+  case array:
+    return std::binary_search(values.begin(), values.end(), v);
+  case bitmap:
+    return _test(v);
+  case runs: {
+    // Last run starting at or before v
+    std::size_t lo = 0, hi = values.size() / 2;
+    while (lo < hi) {
+      std::size_t mid = (lo + hi) / 2;
+      if (values[2 * mid] <= v)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo > 0 && v - values[2 * (lo - 1)] <= values[2 * (lo - 1) + 1];
+  }
+  }
+  return false;
+}
+
+inline bool RoaringContainer::insert(std::uint16_t v) {
+  if (kind == runs)
+    _expand();
+  if (kind == bitmap) {
+    if (_test(v))
+      return false;
+    _set(v);
+    ++cardinality;
+    return true;
+  }
+
+  auto it = std::lower_bound(values.begin(), values.end(), v);
+  if (it != values.end() && *it == v)
+    return false;
+  if (cardinality == max_array_size) {
+    _to_bitmap();
+    return insert(v);
+  }
+  values.insert(it, v);
+  ++cardinality;
+  return true;
+}
+
+inline bool RoaringContainer::erase(std::uint16_t v) {
+  if (kind == runs)
+    _expand();
+  if (kind == bitmap) {
+    if (!_test(v))
+      return false;
+    words[v >> 6] &= ~(std::uint64_t(1) << (v & 63));
+    if (--cardinality <= max_array_size)
+      _to_array();
+    return true;
+  }
+
+  auto it = std::lower_bound(values.begin(), values.end(), v);
+  if (it == values.end() || *it != v)
+    return false;
+  values.erase(it);
+  --cardinality;
+  return true;
+}
+
+template <class F> void RoaringContainer::for_each(F f) const {
+  switch (kind) {
+  case array:
+    for (std::uint16_t v : values)
+      f(v);
+    break;
+  case bitmap:
+    for (std::size_t i = 0; i < bitmap_words; ++i)
+      for (std::uint64_t w = words[i]; w; w &= w - 1)
+        f(static_cast<std::uint16_t>(i * 64 + count_trailing_zeros(w)));
+    break;
+  case runs:
+    for (std::size_t r = 0; r < values.size(); r += 2)
+      for (std::uint32_t v = values[r]; v <= values[r] + values[r + 1]; ++v)
+        f(static_cast<std::uint16_t>(v));
+    break;
+  }
+}
+
+inline void RoaringContainer::optimize() {
+  std::size_t run_count = 0;
+  std::uint32_t previous = 0;
+  bool first = true;
+  for_each([&](std::uint16_t v) {
+    if (first || v != previous + 1)
+      ++run_count;
+    first = false;
+    previous = v;
+  });
+
+  std::size_t run_bytes = run_count * 2 * sizeof(std::uint16_t);
+  std::size_t other_bytes =
+      cardinality <= max_array_size
+          ? cardinality * sizeof(std::uint16_t)
+          : bitmap_words * sizeof(std::uint64_t);
+  if (run_bytes >= other_bytes) {
+    if (kind == runs)
+      _expand();
+    values.shrink_to_fit();
+    return;
+  }
+  if (kind == runs)
+    return;
+
+  std::vector<std::uint16_t> r;
+  r.reserve(run_count * 2);
+  for_each([&r](std::uint16_t v) {
+    if (!r.empty() && v == r[r.size() - 2] + r.back() + 1)
+      ++r.back();
+    else
+      r.insert(r.end(), {v, 0});
+  });
+  values = std::move(r);
+  words = std::vector<std::uint64_t>();
+  kind = runs;
+}
+
+inline RoaringContainer RoaringContainer::unite(const RoaringContainer &a,
+                                                const RoaringContainer &b) {
+  if (a.kind == runs || b.kind == runs) {
+    RoaringContainer ea = a, eb = b;
+    ea._normalize();
+    eb._normalize();
+    return unite(ea, eb);
+  }
+
+  RoaringContainer result;
+  if (a.kind == array && b.kind == array) {
+    result.values.reserve(a.values.size() + b.values.size());
+    std::set_union(a.values.begin(), a.values.end(), b.values.begin(),
+                   b.values.end(), std::back_inserter(result.values));
+    result.cardinality = static_cast<std::uint32_t>(result.values.size());
+    result._normalize();
+    return result;
+  }
+
+  const RoaringContainer &map = a.kind == bitmap ? a : b;
+  const RoaringContainer &other = a.kind == bitmap ? b : a;
+  result = map;
+  if (other.kind == bitmap) {
+    // Written so that compilers vectorize it
+    for (std::size_t i = 0; i < bitmap_words; ++i)
+      result.words[i] |= other.words[i];
+    result._count_bits();
+  } else {
+    for (std::uint16_t v : other.values)
+      if (!result._test(v)) {
+        result._set(v);
+        ++result.cardinality;
+      }
+  }
+  return result;
+}
+
+inline RoaringContainer RoaringContainer::intersect(const RoaringContainer &a,
+                                                    const RoaringContainer &b) {
+  if (a.kind == runs || b.kind == runs) {
+    RoaringContainer ea = a, eb = b;
+    ea._normalize();
+    eb._normalize();
+    return intersect(ea, eb);
+  }
+
+  RoaringContainer result;
+  if (a.kind == bitmap && b.kind == bitmap) {
+    result.kind = bitmap;
+    result.words.resize(bitmap_words);
+    for (std::size_t i = 0; i < bitmap_words; ++i)
+      result.words[i] = a.words[i] & b.words[i];
+    result._count_bits();
+    result._normalize();
+    return result;
+  }
+
+  if (a.kind == array && b.kind == array) {
+    std::set_intersection(a.values.begin(), a.values.end(), b.values.begin(),
+                          b.values.end(), std::back_inserter(result.values));
+  } else {
+    const RoaringContainer &map = a.kind == bitmap ? a : b;
+    const RoaringContainer &other = a.kind == bitmap ? b : a;
+    for (std::uint16_t v : other.values)
+      if (map._test(v))
+        result.values.push_back(v);
+  }
+  result.cardinality = static_cast<std::uint32_t>(result.values.size());
+  return result;
+}
+
+inline void RoaringContainer::_normalize() {
+  if (kind == runs)
+    _expand();
+  else if (kind == array && cardinality > max_array_size)
+    _to_bitmap();
+  else if (kind == bitmap && cardinality <= max_array_size)
+    _to_array();
+}
+
+inline void RoaringContainer::_to_bitmap() {
+  std::vector<std::uint64_t> bits(bitmap_words);
+  words.swap(bits);
+  for (std::uint16_t v : values)
+    _set(v);
+  values = std::vector<std::uint16_t>();
+  kind = bitmap;
+}
+
+inline void RoaringContainer::_to_array() {
+  std::vector<std::uint16_t> sorted;
+  sorted.reserve(cardinality);
+  for_each([&sorted](std::uint16_t v) { sorted.push_back(v); });
+  values.swap(sorted);
+  words = std::vector<std::uint64_t>();
+  kind = RoaringContainer::array;
+}
+
+inline void RoaringContainer::_expand() {
+  std::vector<std::uint16_t> run_values;
+  run_values.swap(values);
+  RoaringContainer expanded;
+  if (cardinality > max_array_size) {
+    expanded.kind = bitmap;
+    expanded.words.resize(bitmap_words);
+  }
+  for (std::size_t r = 0; r < run_values.size(); r += 2)
+    for (std::uint32_t v = run_values[r];
+         v <= run_values[r] + run_values[r + 1]; ++v) {
+      if (expanded.kind == bitmap)
+        expanded._set(static_cast<std::uint16_t>(v));
+      else
+        expanded.values.push_back(static_cast<std::uint16_t>(v));
+    }
+  expanded.cardinality = cardinality;
+  *this = std::move(expanded);
+}
+
+inline void RoaringContainer::_count_bits() {
+  std::uint32_t count = 0;
+  for (std::size_t i = 0; i < bitmap_words; ++i)
+    count += popcount(words[i]);
+  cardinality = count;
+}
+} // namespace details
+
+// Compressed set of integers of up to 32 bits, after the Roaring bitmaps of
+// Chambi, Lemire, Kaser and Godin. The values are split in chunks of 65536
+// according to their high 16 bits, and each chunk stores the low 16 bits of
+// its values in the most compact of a sorted array, a bitmap, or a list of
+// runs of consecutive values. A value costs at most 2 bytes in an array, and
+// far less in a dense chunk, instead of a node and a bucket in a HashTable.
+//
+// The set is ordered: for_each visits the values in increasing order. Union
+// and intersection work chunk by chunk, bitmaps being combined one 64 bit word
+// at a time. The chunks are kept in a sorted array, creating a chunk moves
+// the ones that follow it: sets spread over many chunks are built faster in
+// increasing order.
+template <class Type = std::uint32_t> struct RoaringSet {
+  static_assert(std::is_integral<Type>::value && sizeof(Type) <= 4,
+                "RoaringSet stores integers of up to 32 bits");
+
+  // Constructs an empty set
+  RoaringSet() : _size(0) {}
+  // Constructs a set holding the values of the list
+  // Throw a std::runtime_error if a value appears twice
+  RoaringSet(const std::initializer_list<Type> &);
+
+  // Insert a new value into the set
+  // Throw a std::runtime_error if the value is already in the set
+  void insert(Type);
+
+  // Insert the value if it is not in the set yet. Return true if it was
+  // inserted
+  bool try_insert(Type);
+
+  // Remove the given value from the set
+  void erase(Type);
+
+  // Return true if the value is in the set, false otherwise
+  bool contains(Type) const;
+
+  std::size_t size() const { return _size; }
+
+  // Number of bytes used by the set, including its own size
+  std::size_t memory_usage() const;
+
+  // Store every chunk in its most compact form, converting long sequences of
+  // consecutive values to runs. Runs are expanded again when modified, the
+  // set should be optimized once it is built.
+  void optimize();
+
+  // Call the function on every value, in increasing order
+  template <class F> void for_each(F) const;
+
+  // Union and intersection of sets
+  RoaringSet &operator|=(const RoaringSet &);
+  RoaringSet &operator&=(const RoaringSet &);
+  friend RoaringSet operator|(RoaringSet a, const RoaringSet &b) {
+    return std::move(a |= b);
+  }
+  friend RoaringSet operator&(RoaringSet a, const RoaringSet &b) {
+    return std::move(a &= b);
+  }
+
+private:
+  typedef details::RoaringContainer Container;
+
+  // Sorted high 16 bits of the chunks, and their containers
+  std::vector<std::uint16_t> _keys;
+  std::vector<Container> _containers;
+  std::size_t _size;
+
+  // Map the values to unsigned integers of the same order
+  static std::uint32_t _encode(Type v) {
+    std::uint32_t u = static_cast<std::make_unsigned_t<Type>>(v);
+    if constexpr (std::is_signed<Type>::value)
+      u ^= std::uint32_t(1) << (8 * sizeof(Type) - 1);
+    return u;
+  }
+  static Type _decode(std::uint32_t u) {
+    if constexpr (std::is_signed<Type>::value)
+      u ^= std::uint32_t(1) << (8 * sizeof(Type) - 1);
+    return static_cast<Type>(static_cast<std::make_unsigned_t<Type>>(u));
+  }
+
+  // Return the position of the chunk, or the position where it belongs
+  std::size_t _chunk(std::uint16_t key) const {
+    return static_cast<std::size_t>(
+        std::lower_bound(_keys.begin(), _keys.end(), key) - _keys.begin());
+  }
+  bool _has_chunk(std::size_t pos, std::uint16_t key) const {
+    return pos < _keys.size() && _keys[pos] == key;
+  }
+};
+
+template <class T>
+RoaringSet<T>::RoaringSet(const std::initializer_list<T> &list)
+    : RoaringSet() {
+  for (const auto &e : list)
+    insert(e);
+}
+
+template <class T> void RoaringSet<T>::insert(T value) {
+  if (!try_insert(value))
+    throw std::runtime_error("HashTable insertion error: an element with the "
+                             "same value exists already");
+}
+
+template <class T> bool RoaringSet<T>::try_insert(T value) {
+  std::uint32_t u = _encode(value);
+  std::uint16_t key = static_cast<std::uint16_t>(u >> 16);
+  std::size_t pos = _chunk(key);
+  if (!_has_chunk(pos, key)) {
+    _keys.insert(_keys.begin() + pos, key);
+    _containers.insert(_containers.begin() + pos, Container());
+  }
+  if (!_containers[pos].insert(static_cast<std::uint16_t>(u)))
+    return false;
+  ++_size;
+  return true;
+}
+
+template <class T> void RoaringSet<T>::erase(T value) {
+  std::uint32_t u = _encode(value);
+  std::uint16_t key = static_cast<std::uint16_t>(u >> 16);
+  std::size_t pos = _chunk(key);
+  if (!_has_chunk(pos, key) ||
+      !_containers[pos].erase(static_cast<std::uint16_t>(u)))
+    return;
+  --_size;
+  if (_containers[pos].cardinality == 0) {
+    _keys.erase(_keys.begin() + pos);
+    _containers.erase(_containers.begin() + pos);
+  }
+}
+
+template <class T> bool RoaringSet<T>::contains(T value) const {
+  std::uint32_t u = _encode(value);
+  std::uint16_t key = static_cast<std::uint16_t>(u >> 16);
+  std::size_t pos = _chunk(key);
+  return _has_chunk(pos, key) &&
+         _containers[pos].contains(static_cast<std::uint16_t>(u));
+}
+
+template <class T> std::size_t RoaringSet<T>::memory_usage() const {
+  std::size_t bytes = sizeof(*this) + _keys.capacity() * sizeof(std::uint16_t);
+  for (const Container &c : _containers)
+    bytes += c.memory_usage();
+  // Unused capacity of the container array
+  return bytes + (_containers.capacity() - _containers.size()) *
+                     sizeof(Container);
+}
+
+template <class T> void RoaringSet<T>::optimize() {
+  for (Container &c : _containers)
+    c.optimize();
+  _keys.shrink_to_fit();
+  _containers.shrink_to_fit();
+}
+
+template <class T> template <class F> void RoaringSet<T>::for_each(F f) const {
+  for (std::size_t i = 0; i < _keys.size(); ++i) {
+    std::uint32_t high = std::uint32_t(_keys[i]) << 16;
+    _containers[i].for_each([&f, high](std::uint16_t low) {
+      f(_decode(high | low));
+    });
+  }
+}
+
+template <class T>
+RoaringSet<T> &RoaringSet<T>::operator|=(const RoaringSet<T> &other) {
+  std::vector<std::uint16_t> keys;
+  std::vector<Container> containers;
+  keys.reserve(_keys.size() + other._keys.size());
+  containers.reserve(_keys.size() + other._keys.size());
+
+  // Merge the sorted chunk lists
+  std::size_t i = 0, j = 0;
+  while (i < _keys.size() || j < other._keys.size()) {
+    if (j == other._keys.size() ||
+        (i < _keys.size() && _keys[i] < other._keys[j])) {
+      keys.push_back(_keys[i]);
+      containers.push_back(std::move(_containers[i++]));
+    } else if (i == _keys.size() || other._keys[j] < _keys[i]) {
+      keys.push_back(other._keys[j]);
+      containers.push_back(other._containers[j++]);
+    } else {
+      keys.push_back(_keys[i]);
+      containers.push_back(Container::unite(_containers[i++],
+                                            other._containers[j++]));
+    }
+  }
+
+  _keys.swap(keys);
+  _containers.swap(containers);
+  _size = 0;
+  for (const Container &c : _containers)
+    _size += c.cardinality;
+  return *this;
+}
+
+template <class T>
+RoaringSet<T> &RoaringSet<T>::operator&=(const RoaringSet<T> &other) {
+  std::vector<std::uint16_t> keys;
+  std::vector<Container> containers;
+
+  // Only the chunks present in both sets can hold common values
+  std::size_t i = 0, j = 0;
+  while (i < _keys.size() && j < other._keys.size()) {
+    if (_keys[i] < other._keys[j]) {
+      ++i;
+    } else if (other._keys[j] < _keys[i]) {
+      ++j;
+    } else {
+      Container c =
+          Container::intersect(_containers[i], other._containers[j]);
+      if (c.cardinality > 0) {
+        keys.push_back(_keys[i]);
+        containers.push_back(std::move(c));
+      }
+      ++i;
+      ++j;
+    }
+  }
+
+  _keys.swap(keys);
+  _containers.swap(containers);
+  _size = 0;
+  for (const Container &c : _containers)
+    _size += c.cardinality;
+  return *this;
+}
+
+#endif // GUARD_ROARING_SET_HPP__
@@ -0,0 +1,278 @@
+#ifndef GUARD_ROBIN_HOOD_HASH_TABLE_HPP__
+#define GUARD_ROBIN_HOOD_HASH_TABLE_HPP__
+
+#include "details/hash.hpp"
+#include "details/maybe.hpp"
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Open addressing hash table using Robin Hood probing: on collision, the
+// element that is further away from its ideal position keeps the slot. All
+// elements live in a single flat array, deletion shifts the following elements
+// backward instead of leaving tombstones.
+template <class Type, class HashFunctor = hash<Type>>
+struct RobinHoodHashTable {
+  // Constructs an empty hash table
+  RobinHoodHashTable();
+  // Constructs a hash table initialized with the list of parameters
+  RobinHoodHashTable(const std::initializer_list<Type> &);
+  RobinHoodHashTable(const RobinHoodHashTable &);
+  RobinHoodHashTable(RobinHoodHashTable &&);
+
+  ~RobinHoodHashTable();
+
+  // Insert a new value into the table
+  // Throw a std::runtime_error if the value is already in the table
+  void insert(const Type &);
+
+  // Remove the given value from the table
+  void erase(const Type &);
+
+  // Return the value matching the argument.
+  // Throw a std::out_of_range if the value is not in the table
+  Type operator[](const Type &) const;
+  Type &operator[](const Type &);
+
+  std::size_t size() const { return _size; }
+
+  // Structure that may contain a value or not
+  template <class T> using Maybe = details::Maybe<T>;
+
+  // Returns a dereferenceable structure that may contain the searched value
+  // Implicitely convertible to bool with true value if the searched value is
+  // contained, false value if the value is not contained
+  Maybe<const Type> find(const Type &) const;
+  Maybe<Type> find(const Type &);
+
+  // Return true if the value is in the table, false otherwise
+  bool contains(const Type &) const;
+
+private:
+  // A slot is empty when its distance is 0, otherwise it contains a value
+  // stored distance - 1 positions after its ideal position
+  struct Slot {
+    std::uint32_t distance = 0;
+    std::aligned_storage_t<sizeof(Type), alignof(Type)> storage;
+
+    Type &value() { return *reinterpret_cast<Type *>(&storage); }
+    const Type &value() const {
+      return *reinterpret_cast<const Type *>(&storage);
+    }
+  };
+
+  std::size_t _size, _capacity;
+  Slot *_slots;
+
+  // Capacity is always a power of 2 so that positions can be computed with a
+  // mask. The table grows when it gets 7/8 full.
+  static constexpr std::size_t _initial_capacity = 8;
+  bool _needs_resize() const { return (_size + 1) * 8 > _capacity * 7; }
+  std::size_t _ideal_position(const Type &val) const {
+    return details::mix_hash(HashFunctor()(val)) & (_capacity - 1);
+  }
+
+  void _resize();
+  // Return the position of the value, or _capacity if it is not in the table
+  std::size_t _position_of(const Type &) const;
+  // Store the value starting the search for a free slot at the given position
+  // and distance, displacing richer elements along the way
+  void _place(Type, std::size_t, std::uint32_t);
+  static void _destroy(Slot *, std::size_t);
+};
+
+template <class T, class H>
+RobinHoodHashTable<T, H>::RobinHoodHashTable()
+    : _size(0), _capacity(_initial_capacity),
+      _slots(new Slot[_initial_capacity]) {}
+
+template <class T, class H>
+RobinHoodHashTable<T, H>::RobinHoodHashTable(
+    const std::initializer_list<T> &list)
+    : RobinHoodHashTable() {
+  for (const auto &e : list) {
+    insert(e);
+  }
+}
+
+template <class T, class H>
+RobinHoodHashTable<T, H>::RobinHoodHashTable(const RobinHoodHashTable<T, H> &h)
+    : _size(0), _capacity(h._capacity), _slots(new Slot[_capacity]) {
+  // Positions do not depend on the insertion order, the layout can be copied
+  // slot by slot
+  try {
+    for (std::size_t i = 0; i < _capacity; ++i) {
+      if (h._slots[i].distance) {
+        ::new (&_slots[i].storage) T(h._slots[i].value());
+        _slots[i].distance = h._slots[i].distance;
+        ++_size;
+      }
+    }
+  } catch (...) {
+    _destroy(_slots, _capacity);
+    throw;
+  }
+}
+
+template <class T, class H>
+RobinHoodHashTable<T, H>::RobinHoodHashTable(RobinHoodHashTable<T, H> &&h)
+    : RobinHoodHashTable() {
+  // The empty slots left to h are allocated before anything is taken from h,
+  // so that h still owns its elements if the allocation throws
+  std::swap(_size, h._size);
+  std::swap(_capacity, h._capacity);
+  std::swap(_slots, h._slots);
+}
+
+template <class T, class H> RobinHoodHashTable<T, H>::~RobinHoodHashTable() {
+  _destroy(_slots, _capacity);
+}
+
+template <class T, class H>
+void RobinHoodHashTable<T, H>::insert(const T &val) {
+  std::size_t pos = _ideal_position(val);
+  std::uint32_t distance = 1;
+
+  // Elements that are at least as far from their ideal position as the new
+  // value would be are skipped, if the value is in the table it is among them
+  while (_slots[pos].distance >= distance) {
+    if (_slots[pos].value() == val)
+      throw std::runtime_error("HashTable insertion error: an element with the "
+                               "same value exists already");
+    pos = (pos + 1) & (_capacity - 1);
+    ++distance;
+  }
+
+  // Only a value that is inserted may grow the table, its slot is then
+  // searched again in the new array
+  if (_needs_resize()) {
+    _resize();
+    pos = _ideal_position(val);
+    distance = 1;
+    while (_slots[pos].distance >= distance) {
+      pos = (pos + 1) & (_capacity - 1);
+      ++distance;
+    }
+  }
+
+  _place(val, pos, distance);
+  ++_size;
+}
+
+template <class T, class H> void RobinHoodHashTable<T, H>::erase(const T &val) {
+  std::size_t pos = _position_of(val);
+  if (pos == _capacity)
+    return;
+
+  _slots[pos].value().~T();
+  --_size;
+
+  // Shift the following elements back by one slot until reaching an empty
+  // slot or an element already at its ideal position
+  std::size_t next = (pos + 1) & (_capacity - 1);
+  while (_slots[next].distance > 1) {
+    ::new (&_slots[pos].storage) T(std::move(_slots[next].value()));
+    _slots[pos].distance = _slots[next].distance - 1;
+    _slots[next].value().~T();
+    pos = next;
+    next = (next + 1) & (_capacity - 1);
+  }
+  _slots[pos].distance = 0;
+}
+
+template <class T, class H>
+typename RobinHoodHashTable<T, H>::template Maybe<const T>
+RobinHoodHashTable<T, H>::find(const T &value) const {
+  return const_cast<RobinHoodHashTable<T, H> *>(this)->find(value);
+}
+
+template <class T, class H>
+typename RobinHoodHashTable<T, H>::template Maybe<T>
+RobinHoodHashTable<T, H>::find(const T &value) {
+  std::size_t pos = _position_of(value);
+  return Maybe<T>(pos == _capacity ? nullptr : &_slots[pos].value());
+}
+
+template <class T, class H>
+T RobinHoodHashTable<T, H>::operator[](const T &val) const {
+  return const_cast<RobinHoodHashTable<T, H> *>(this)->operator[](val);
+}
+
+template <class T, class H>
+T &RobinHoodHashTable<T, H>::operator[](const T &value) {
+  auto maybe = find(value);
+  if (!maybe)
+    throw std::out_of_range(
+        "HashTable::operator[] : the given key is not in the table");
+  return *maybe;
+}
+
+template <class T, class H>
+bool RobinHoodHashTable<T, H>::contains(const T &value) const {
+  return find(value);
+}
+
+template <class T, class H> void RobinHoodHashTable<T, H>::_resize() {
+  std::size_t old_capacity = _capacity;
+  Slot *old_slots = _slots;
+
+  _slots = new Slot[_capacity * 2];
+  _capacity *= 2;
+
+  // Values are known to be unique, they can be placed without comparison
+  for (std::size_t i = 0; i < old_capacity; ++i) {
+    if (old_slots[i].distance) {
+      T &value = old_slots[i].value();
+      std::size_t pos = _ideal_position(value);
+      _place(std::move(value), pos, 1);
+    }
+  }
+
+  _destroy(old_slots, old_capacity);
+}
+
+template <class T, class H>
+std::size_t RobinHoodHashTable<T, H>::_position_of(const T &val) const {
+  std::size_t pos = _ideal_position(val);
+  std::uint32_t distance = 1;
+
+  // If an element closer to its ideal position than the searched value would
+  // be is found, the value would have displaced it: it is not in the table
+  while (_slots[pos].distance >= distance) {
+    if (_slots[pos].value() == val)
+      return pos;
+    pos = (pos + 1) & (_capacity - 1);
+    ++distance;
+  }
+  return _capacity;
+}
+
+template <class T, class H>
+void RobinHoodHashTable<T, H>::_place(T value, std::size_t pos,
+                                      std::uint32_t distance) {
+  while (_slots[pos].distance != 0) {
+    // Take from the rich (close to their ideal position) and give to the poor
+    if (_slots[pos].distance < distance) {
+      using std::swap;
+      swap(value, _slots[pos].value());
+      std::swap(distance, _slots[pos].distance);
+    }
+    pos = (pos + 1) & (_capacity - 1);
+    ++distance;
+  }
+  ::new (&_slots[pos].storage) T(std::move(value));
+  _slots[pos].distance = distance;
+}
+
+template <class T, class H>
+void RobinHoodHashTable<T, H>::_destroy(Slot *slots, std::size_t capacity) {
+  for (std::size_t i = 0; i < capacity; ++i)
+    if (slots[i].distance)
+      slots[i].value().~T();
+  delete[] slots;
+}
+
+#endif // GUARD_ROBIN_HOOD_HASH_TABLE_HPP__
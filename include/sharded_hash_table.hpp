@@ -0,0 +1,247 @@
+#ifndef GUARD_SHARDED_HASH_TABLE_HPP__
+#define GUARD_SHARDED_HASH_TABLE_HPP__
+
+#include "details/hash.hpp"
+#include "hash_table.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+// Hash table split into a fixed number of independent HashTable shards. The
+// high bits of the mixed hash of a value select its shard, the shard then
+// uses the low bits to select a bucket. Each shard grows on its own: a resize
+// only moves the elements of one shard, and never stalls the others. All the
+// shards share the hash functor of the table, so that a hash computed to
+// select a shard is valid in the shard.
+//
+// Since the shards share nothing, they can be filled in parallel. bulk_build
+// distributes a range of values between the shards using several threads,
+// then fills every shard on its own thread. The table itself is not safe for
+// concurrent use, see ConcurrentHashTable for that.
+template <class Type, class HashFunctor = hash<Type>,
+          bool CacheHash = details::cache_hash_by_default<Type>::value>
+struct ShardedHashTable {
+  typedef HashTable<Type, HashFunctor, CacheHash> shard_type;
+
+  // Constructs an empty table with the given number of shards, rounded up to
+  // a power of 2
+  explicit ShardedHashTable(std::size_t shards = 16);
+  // Constructs a table initialized with the list of parameters
+  ShardedHashTable(const std::initializer_list<Type> &);
+
+  // Insert every value of the range, using the given number of threads (the
+  // number of hardware threads by default). The values are copied.
+  // Throw a std::runtime_error if a value appears twice or is already in the
+  // table, the table then holds an unspecified part of the range
+  template <class ForwardIt>
+  void bulk_build(ForwardIt, ForwardIt,
+                  unsigned threads = std::thread::hardware_concurrency());
+
+  // Insert a new value into the table
+  // Throw a std::runtime_error if the value is already in the table
+  void insert(const Type &value) { _shard_for(value).insert(value); }
+  void insert(Type &&value) { _shard_for(value).insert(std::move(value)); }
+
+  // Remove the given value from the table
+  void erase(const Type &value) { _shard_for(value).erase(value); }
+
+  // Structure that may contain a value or not
+  template <class T> using Maybe = details::Maybe<T>;
+
+  // Return the value matching the argument.
+  // Throw a std::out_of_range if the value is not in the table
+  Type operator[](const Type &value) const { return _shard_for(value)[value]; }
+  Type &operator[](const Type &value) { return _shard_for(value)[value]; }
+
+  // Returns a dereferenceable structure that may contain the searched value
+  // Implicitely convertible to bool with true value if the searched value is
+  // contained, false value if the value is not contained
+  Maybe<const Type> find(const Type &value) const {
+    return _shard_for(value).find(value);
+  }
+  Maybe<Type> find(const Type &value) { return _shard_for(value).find(value); }
+
+  // Return true if the value is in the table, false otherwise
+  bool contains(const Type &value) const {
+    return _shard_for(value).contains(value);
+  }
+
+  // Lookups with a different type than the stored one, available if the hash
+  // functor is transparent
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  Maybe<const Type> find(const K &key) const {
+    return _shard_for(key).find(key);
+  }
+  template <class K,
+            class = details::enable_if_transparent_t<HashFunctor, Type, K>>
+  bool contains(const K &key) const {
+    return _shard_for(key).contains(key);
+  }
+
+  // Total number of elements of the shards
+  std::size_t size() const;
+
+  std::size_t shard_count() const { return _shards.size(); }
+  const shard_type &shard(std::size_t i) const { return _shards[i]; }
+  shard_type &shard(std::size_t i) { return _shards[i]; }
+
+  // Return the index of the shard holding the given value
+  template <class K> std::size_t shard_of(const K &key) const {
+    return _shard_for_hash(_hasher(key));
+  }
+
+  // Call the function on every element of every shard
+  template <class F> void for_each(F f) const {
+    for (const shard_type &s : _shards)
+      s.for_each(f);
+  }
+
+private:
+  HashFunctor _hasher;
+  std::vector<shard_type> _shards;
+  // log2 of the number of shards
+  unsigned _shard_bits;
+
+  std::size_t _shard_for_hash(std::size_t h) const {
+    if (_shard_bits == 0)
+      return 0;
+    return details::mix_hash(h) >>
+           (std::numeric_limits<std::size_t>::digits - _shard_bits);
+  }
+
+  template <class K> shard_type &_shard_for(const K &key) {
+    return _shards[shard_of(key)];
+  }
+  template <class K> const shard_type &_shard_for(const K &key) const {
+    return _shards[shard_of(key)];
+  }
+
+  // Call f(i) for every i of [0, count) on the given number of threads, and
+  // rethrow the first exception thrown by a call
+  template <class F>
+  static void _parallel_for(std::size_t count, unsigned threads, F f);
+};
+
+template <class T, class H, bool C>
+ShardedHashTable<T, H, C>::ShardedHashTable(std::size_t shards)
+    : _hasher(details::make_hash_functor<H>()),
+      _shards(details::next_power_of_2(shards), shard_type(_hasher)),
+      _shard_bits(0) {
+  while ((std::size_t(1) << _shard_bits) < _shards.size())
+    ++_shard_bits;
+}
+
+template <class T, class H, bool C>
+ShardedHashTable<T, H, C>::ShardedHashTable(
+    const std::initializer_list<T> &list)
+    : ShardedHashTable() {
+  for (const auto &e : list)
+    insert(e);
+}
+
+template <class T, class H, bool C>
+std::size_t ShardedHashTable<T, H, C>::size() const {
+  std::size_t size = 0;
+  for (const shard_type &s : _shards)
+    size += s.size();
+  return size;
+}
+
+template <class T, class H, bool C>
+template <class ForwardIt>
+void ShardedHashTable<T, H, C>::bulk_build(ForwardIt first, ForwardIt last,
+                                           unsigned threads) {
+  std::size_t count = static_cast<std::size_t>(std::distance(first, last));
+  if (threads == 0)
+    threads = 1;
+  std::size_t chunks = std::min<std::size_t>(threads, count);
+  if (chunks == 0)
+    return;
+
+  // Split the range in one chunk per thread, and sort the values of each
+  // chunk by shard. parts[c * shard_count() + s] holds the values of chunk c
+  // that belong to shard s, with their hashes.
+  std::vector<ForwardIt> bounds{first};
+  for (std::size_t c = 0; c < chunks; ++c)
+    bounds.push_back(std::next(bounds.back(), (count * (c + 1)) / chunks -
+                                                  (count * c) / chunks));
+  typedef std::pair<std::size_t, const T *> Hashed;
+  std::vector<std::vector<Hashed>> parts(chunks * shard_count());
+  _parallel_for(chunks, threads, [&](std::size_t c) {
+    for (ForwardIt it = bounds[c]; it != bounds[c + 1]; ++it) {
+      std::size_t h = _hasher(*it);
+      parts[c * shard_count() + _shard_for_hash(h)].emplace_back(h, &*it);
+    }
+  });
+
+  // Fill every shard, growing it once to its final size. The values are not
+  // hashed again.
+  _parallel_for(shard_count(), threads, [&](std::size_t s) {
+    shard_type &shard = _shards[s];
+    std::size_t added = 0;
+    for (std::size_t c = 0; c < chunks; ++c)
+      added += parts[c * shard_count() + s].size();
+    shard.reserve(shard.size() + added);
+    for (std::size_t c = 0; c < chunks; ++c) {
+      for (const Hashed &value : parts[c * shard_count() + s]) {
+        if (shard._find(*value.second, value.first))
+          throw std::runtime_error("HashTable insertion error: an element "
+                                   "with the same value exists already");
+        shard._insert(value.first, *value.second);
+      }
+    }
+  });
+}
+
+template <class T, class H, bool C>
+template <class F>
+void ShardedHashTable<T, H, C>::_parallel_for(std::size_t count,
+                                              unsigned threads, F f) {
+  if (threads <= 1 || count <= 1) {
+    for (std::size_t i = 0; i < count; ++i)
+      f(i);
+    return;
+  }
+
+  // Every thread takes the next index until none is left, so that a slow
+  // index does not hold the others back
+  std::atomic<std::size_t> next{0};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto work = [&]() {
+    try {
+      for (std::size_t i; (i = next.fetch_add(1)) < count;)
+        f(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+      next.store(count);
+    }
+  };
+
+  std::vector<std::thread> workers;
+  try {
+    for (std::size_t t = 1; t < std::min<std::size_t>(threads, count); ++t)
+      workers.emplace_back(work);
+  } catch (const std::system_error &) {
+    // The threads already started do the work
+  }
+  work();
+  for (std::thread &w : workers)
+    w.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+#endif // GUARD_SHARDED_HASH_TABLE_HPP__
@@ -2,8 +2,10 @@
 #define GUARD_SINGLE_LINKED_LIST_HPP__
 
 #include <algorithm>
+#include <cstddef>
 #include <initializer_list>
 #include <type_traits>
+#include <utility>
 
 template <class Type> class SingleLinkedList {
 public:
@@ -33,11 +35,11 @@ public:
 private:
   struct Node {
     Node() noexcept = default;
-    explicit Node(nullptr_t) noexcept : _next(nullptr) {}
+    explicit Node(std::nullptr_t) noexcept : _next(nullptr) {}
     explicit Node(Type t) : _next(new Node()) {
       ::new (&_storage) Type(std::move(t));
     }
-    Node(Type t, nullptr_t) = delete;
+    Node(Type t, std::nullptr_t) = delete;
     Node(Type t, Node *n) : _next(n) { ::new (&_storage) Type(std::move(t)); }
     Node(Node &&node) noexcept : _next(std::exchange(node._next, nullptr)) {
       if (_next)
@@ -0,0 +1,119 @@
+#ifndef GUARD_STATIC_HASH_TABLE_HPP__
+#define GUARD_STATIC_HASH_TABLE_HPP__
+
+#include "details/hash.hpp"
+#include "details/maybe.hpp"
+#include "static_array.hpp"
+#include <initializer_list>
+#include <stdexcept>
+
+// Hash table of a fixed number of values, which can be built in constant
+// expressions. Declared constexpr, the whole table is computed by the
+// compiler and stored in read-only memory: it costs no initialization at
+// runtime. The values are kept in a StaticArray, in the order of their
+// declaration, and located through an open addressing index of positions,
+// twice as large as the number of values, probed linearly.
+//
+// Both the values and the hash functor must be usable in constant expressions,
+// which is the case of integers and string views with the default functor.
+template <class Type, std::size_t Size, class HashFunctor = hash<Type>>
+struct StaticHashTable {
+  // Constructs a table holding the values of the list
+  // Throw a std::invalid_argument if the list does not hold Size values, and a
+  // std::runtime_error if a value appears twice
+  constexpr StaticHashTable(const std::initializer_list<Type> &);
+
+  constexpr std::size_t size() const { return Size; }
+
+  // Return the value matching the argument.
+  // Throw a std::out_of_range if the value is not in the table
+  constexpr const Type &operator[](const Type &) const;
+
+  // Structure that may contain a value or not
+  template <class T> using Maybe = details::Maybe<T>;
+
+  // Returns a dereferenceable structure that may contain the searched value
+  // Implicitely convertible to bool with true value if the searched value is
+  // contained, false value if the value is not contained
+  constexpr Maybe<const Type> find(const Type &) const;
+
+  // Return true if the value is in the table, false otherwise
+  constexpr bool contains(const Type &) const;
+
+  // The values in the order they were given
+  constexpr const StaticArray<Type, Size> &values() const { return _values; }
+
+private:
+  // Power of 2 so that positions are computed with a mask
+  static constexpr std::size_t _capacity = details::next_power_of_2(2 * Size);
+
+  StaticArray<Type, Size> _values;
+  // Position of a value in _values plus one, 0 for an empty slot
+  StaticArray<std::size_t, _capacity> _index;
+
+  static constexpr std::size_t _ideal_position(const Type &value) {
+    return details::mix_hash(HashFunctor()(value)) & (_capacity - 1);
+  }
+
+  static constexpr StaticArray<std::size_t, _capacity>
+  _build_index(const StaticArray<Type, Size> &);
+
+  // Return the matching value, or nullptr if it is not in the table
+  constexpr const Type *_find(const Type &) const;
+};
+
+template <class T, std::size_t S, class H>
+constexpr StaticHashTable<T, S, H>::StaticHashTable(
+    const std::initializer_list<T> &list)
+    : _values(list), _index(_build_index(_values)) {}
+
+template <class T, std::size_t S, class H>
+constexpr StaticArray<std::size_t, StaticHashTable<T, S, H>::_capacity>
+StaticHashTable<T, S, H>::_build_index(const StaticArray<T, S> &values) {
+  std::size_t index[_capacity] = {};
+  for (std::size_t i = 0; i < S; ++i) {
+    std::size_t pos = _ideal_position(values[i]);
+    while (index[pos] != 0) {
+      if (values[index[pos] - 1] == values[i])
+        throw std::runtime_error("HashTable insertion error: an element with "
+                                 "the same value exists already");
+      pos = (pos + 1) & (_capacity - 1);
+    }
+    index[pos] = i + 1;
+  }
+  return StaticArray<std::size_t, _capacity>(index);
+}
+
+template <class T, std::size_t S, class H>
+constexpr const T *StaticHashTable<T, S, H>::_find(const T &value) const {
+  // The index is never full, the search stops on an empty slot
+  for (std::size_t pos = _ideal_position(value); _index[pos] != 0;
+       pos = (pos + 1) & (_capacity - 1)) {
+    const T &candidate = _values[_index[pos] - 1];
+    if (candidate == value)
+      return &candidate;
+  }
+  return nullptr;
+}
+
+template <class T, std::size_t S, class H>
+constexpr const T &StaticHashTable<T, S, H>::operator[](const T &value) const {
+  const T *found = _find(value);
+  if (!found)
+    throw std::out_of_range(
+        "HashTable::operator[] : the given key is not in the table");
+  return *found;
+}
+
+template <class T, std::size_t S, class H>
+constexpr typename StaticHashTable<T, S, H>::template Maybe<const T>
+StaticHashTable<T, S, H>::find(const T &value) const {
+  return Maybe<const T>(_find(value));
+}
+
+template <class T, std::size_t S, class H>
+constexpr bool StaticHashTable<T, S, H>::contains(const T &value) const {
+  return _find(value) != nullptr;
+}
+
+#endif // GUARD_STATIC_HASH_TABLE_HPP__
@@ -0,0 +1,383 @@
+#ifndef GUARD_SWISS_HASH_TABLE_HPP__
+#define GUARD_SWISS_HASH_TABLE_HPP__
+
+#include "details/hash.hpp"
+#include "details/maybe.hpp"
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GUARD_SWISS_HASH_TABLE_SSE2__
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace details {
+// Index of the lowest bit set in a non-zero mask
+inline unsigned lowest_bit_index(unsigned mask) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+// Control bytes of 16 consecutive slots. A control byte is either one of the
+// special values below (high bit set) or the 7 bit tag of the hash of the
+// value stored in the slot.
+struct alignas(16) ControlGroup {
+  static constexpr signed char empty = -128;
+  static constexpr signed char deleted = -2;
+  static constexpr unsigned width = 16;
+
+  signed char bytes[width];
+
+  // Return a mask where bit i is set if the control byte i is equal to the
+  // argument
+  unsigned match(signed char tag) const {
+#ifdef GUARD_SWISS_HASH_TABLE_SSE2__
+    __m128i group = _mm_load_si128(reinterpret_cast<const __m128i *>(bytes));
+    return static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), group)));
+#else
+    return match_scalar(tag);
+#endif
+  }
+
+  unsigned match_empty() const { return match(empty); }
+
+  // Return a mask where bit i is set if the slot i is either empty or deleted
+  unsigned match_free() const {
+#ifdef GUARD_SWISS_HASH_TABLE_SSE2__
+    // Special values are the only ones with the sign bit set
+    return static_cast<unsigned>(_mm_movemask_epi8(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(bytes))));
+#else
+    return match_free_scalar();
+#endif
+  }
+
+  // Portable versions of match and match_free, used when SSE2 is not
+  // available. They are always compiled so that they can be tested.
+  unsigned match_scalar(signed char tag) const {
+    unsigned mask = 0;
+    for (unsigned i = 0; i < width; ++i)
+      mask |= static_cast<unsigned>(bytes[i] == tag) << i;
+    return mask;
+  }
+  unsigned match_free_scalar() const {
+    unsigned mask = 0;
+    for (unsigned i = 0; i < width; ++i)
+      mask |= static_cast<unsigned>(bytes[i] < 0) << i;
+    return mask;
+  }
+};
+} // namespace details
+
+// Open addressing hash table in the style of Swiss tables. Next to the flat
+// array of elements, the table keeps one control byte per slot holding 7 bits
+// of the hash of the element. Slots are probed 16 at a time: the control bytes
+// of a group are compared with the tag of the searched value in a single SIMD
+// instruction, so most slots containing a different value are never touched.
+template <class Type, class HashFunctor = hash<Type>> struct SwissHashTable {
+  // Constructs an empty hash table
+  SwissHashTable();
+  // Constructs a hash table initialized with the list of parameters
+  SwissHashTable(const std::initializer_list<Type> &);
+  SwissHashTable(const SwissHashTable &);
+  SwissHashTable(SwissHashTable &&);
+
+  ~SwissHashTable();
+
+  // Insert a new value into the table
+  // Throw a std::runtime_error if the value is already in the table
+  void insert(const Type &);
+
+  // Remove the given value from the table
+  void erase(const Type &);
+
+  // Return the value matching the argument.
+  // Throw a std::out_of_range if the value is not in the table
+  Type operator[](const Type &) const;
+  Type &operator[](const Type &);
+
+  std::size_t size() const { return _size; }
+
+  // Structure that may contain a value or not
+  template <class T> using Maybe = details::Maybe<T>;
+
+  // Returns a dereferenceable structure that may contain the searched value
+  // Implicitely convertible to bool with true value if the searched value is
+  // contained, false value if the value is not contained
+  Maybe<const Type> find(const Type &) const;
+  Maybe<Type> find(const Type &);
+
+  // Return true if the value is in the table, false otherwise
+  bool contains(const Type &) const;
+
+private:
+  typedef details::ControlGroup Group;
+  typedef std::aligned_storage_t<sizeof(Type), alignof(Type)> Slot;
+
+  std::size_t _size;
+  // Number of groups, always a power of 2
+  std::size_t _groups;
+  // Number of empty slots that can still be filled before the table exceeds
+  // its maximum load of 7/8. Deleted slots are not counted as free.
+  std::size_t _growth_left;
+  Group *_control;
+  Slot *_slots;
+
+  std::size_t _capacity() const { return _groups * Group::width; }
+  Type &_value(std::size_t pos) {
+    return *reinterpret_cast<Type *>(&_slots[pos]);
+  }
+  const Type &_value(std::size_t pos) const {
+    return *reinterpret_cast<const Type *>(&_slots[pos]);
+  }
+  signed char &_control_byte(std::size_t pos) {
+    return _control[pos / Group::width].bytes[pos % Group::width];
+  }
+  signed char _control_byte(std::size_t pos) const {
+    return _control[pos / Group::width].bytes[pos % Group::width];
+  }
+
+  // The high bits of the hash give the tag stored in the control bytes, the
+  // low bits give the first group to probe
+  static std::size_t _hash(const Type &val) {
+    return details::mix_hash(HashFunctor()(val));
+  }
+  static signed char _tag(std::size_t h) {
+    return static_cast<signed char>(
+        h >> (std::numeric_limits<std::size_t>::digits - 7));
+  }
+
+  // Return the position of the value, or _capacity() if it is not in the table
+  std::size_t _position_of(const Type &) const;
+  // Return the position of the first free slot on the probe sequence of h
+  std::size_t _free_position(std::size_t h) const;
+  void _allocate(std::size_t groups);
+  void _resize(std::size_t groups);
+  static void _destroy(Group *, Slot *, std::size_t groups);
+};
+
+template <class T, class H> SwissHashTable<T, H>::SwissHashTable() {
+  _allocate(1);
+}
+
+template <class T, class H>
+SwissHashTable<T, H>::SwissHashTable(const std::initializer_list<T> &list)
+    : SwissHashTable() {
+  for (const auto &e : list) {
+    insert(e);
+  }
+}
+
+template <class T, class H>
+SwissHashTable<T, H>::SwissHashTable(const SwissHashTable<T, H> &h) {
+  _allocate(h._groups);
+  // Positions do not depend on the insertion order, the layout can be copied
+  // slot by slot
+  try {
+    for (std::size_t i = 0; i < _capacity(); ++i) {
+      if (h._control_byte(i) >= 0)
+        ::new (&_slots[i]) T(h._value(i));
+      _control_byte(i) = h._control_byte(i);
+    }
+  } catch (...) {
+    _destroy(_control, _slots, _groups);
+    throw;
+  }
+  _size = h._size;
+  _growth_left = h._growth_left;
+}
+
+template <class T, class H>
+SwissHashTable<T, H>::SwissHashTable(SwissHashTable<T, H> &&h)
+    : SwissHashTable() {
+  // The empty group left to h is allocated before anything is taken from h,
+  // so that h still owns its elements if the allocation throws
+  std::swap(_size, h._size);
+  std::swap(_groups, h._groups);
+  std::swap(_growth_left, h._growth_left);
+  std::swap(_control, h._control);
+  std::swap(_slots, h._slots);
+}
+
+template <class T, class H> SwissHashTable<T, H>::~SwissHashTable() {
+  _destroy(_control, _slots, _groups);
+}
+
+template <class T, class H> void SwissHashTable<T, H>::insert(const T &val) {
+  if (_position_of(val) != _capacity())
+    throw std::runtime_error("HashTable insertion error: an element with the "
+                             "same value exists already");
+
+  std::size_t h = _hash(val);
+  std::size_t pos = _free_position(h);
+
+  // Reusing a deleted slot does not make probe sequences any longer, only
+  // filling an empty slot counts toward the load of the table
+  if (_control_byte(pos) == Group::empty) {
+    if (_growth_left == 0) {
+      // If the table is mostly filled with deleted slots, rehashing at the
+      // same size is enough to get rid of them
+      _resize(_size * 2 + 2 > _capacity() * 7 / 8 ? _groups * 2 : _groups);
+      pos = _free_position(h);
+    }
+    --_growth_left;
+  }
+
+  ::new (&_slots[pos]) T(val);
+  _control_byte(pos) = _tag(h);
+  ++_size;
+}
+
+template <class T, class H> void SwissHashTable<T, H>::erase(const T &val) {
+  std::size_t pos = _position_of(val);
+  if (pos == _capacity())
+    return;
+
+  _value(pos).~T();
+  --_size;
+
+  // Lookups stop at the first group containing an empty slot. If the group
+  // already has one, no probe sequence can go past it and the slot can be
+  // marked empty, otherwise it must stay on the path to the following groups
+  if (_control[pos / Group::width].match_empty()) {
+    _control_byte(pos) = Group::empty;
+    ++_growth_left;
+  } else {
+    _control_byte(pos) = Group::deleted;
+  }
+}
+
+template <class T, class H>
+typename SwissHashTable<T, H>::template Maybe<const T>
+SwissHashTable<T, H>::find(const T &value) const {
+  return const_cast<SwissHashTable<T, H> *>(this)->find(value);
+}
+
+template <class T, class H>
+typename SwissHashTable<T, H>::template Maybe<T>
+SwissHashTable<T, H>::find(const T &value) {
+  std::size_t pos = _position_of(value);
+  return Maybe<T>(pos == _capacity() ? nullptr : &_value(pos));
+}
+
+template <class T, class H>
+T SwissHashTable<T, H>::operator[](const T &val) const {
+  return const_cast<SwissHashTable<T, H> *>(this)->operator[](val);
+}
+
+template <class T, class H>
+T &SwissHashTable<T, H>::operator[](const T &value) {
+  auto maybe = find(value);
+  if (!maybe)
+    throw std::out_of_range(
+        "HashTable::operator[] : the given key is not in the table");
+  return *maybe;
+}
+
+template <class T, class H>
+bool SwissHashTable<T, H>::contains(const T &value) const {
+  return find(value);
+}
+
+template <class T, class H>
+std::size_t SwissHashTable<T, H>::_position_of(const T &val) const {
+  std::size_t h = _hash(val);
+  signed char tag = _tag(h);
+  std::size_t group = h & (_groups - 1);
+
+  // Groups are probed quadratically, which visits every group when their
+  // number is a power of 2
+  for (std::size_t step = 1;; ++step) {
+    const Group &g = _control[group];
+    for (unsigned mask = g.match(tag); mask; mask &= mask - 1) {
+      std::size_t pos =
+          group * Group::width + details::lowest_bit_index(mask);
+      if (_value(pos) == val)
+        return pos;
+    }
+    if (g.match_empty())
+      return _capacity();
+    group = (group + step) & (_groups - 1);
+  }
+}
+
+template <class T, class H>
+std::size_t SwissHashTable<T, H>::_free_position(std::size_t h) const {
+  std::size_t group = h & (_groups - 1);
+  for (std::size_t step = 1;; ++step) {
+    unsigned mask = _control[group].match_free();
+    if (mask)
+      return group * Group::width + details::lowest_bit_index(mask);
+    group = (group + step) & (_groups - 1);
+  }
+}
+
+template <class T, class H>
+void SwissHashTable<T, H>::_allocate(std::size_t groups) {
+  // The members only change once both arrays are allocated: if an allocation
+  // throws during a resize, the table keeps its current arrays
+  std::unique_ptr<Slot[]> slots(new Slot[groups * Group::width]);
+  std::unique_ptr<Group[]> control(new Group[groups]);
+  for (std::size_t i = 0; i < groups; ++i)
+    for (auto &c : control[i].bytes)
+      c = Group::empty;
+  _slots = slots.release();
+  _control = control.release();
+  _size = 0;
+  _groups = groups;
+  _growth_left = _capacity() * 7 / 8;
+}
+
+template <class T, class H>
+void SwissHashTable<T, H>::_resize(std::size_t groups) {
+  Group *old_control = _control;
+  Slot *old_slots = _slots;
+  std::size_t old_groups = _groups;
+  std::size_t size = _size;
+
+  _allocate(groups);
+
+  // Values are known to be unique, they can be placed without comparison
+  for (std::size_t i = 0; i < old_groups * Group::width; ++i) {
+    if (old_control[i / Group::width].bytes[i % Group::width] >= 0) {
+      T &value = *reinterpret_cast<T *>(&old_slots[i]);
+      std::size_t h = _hash(value);
+      std::size_t pos = _free_position(h);
+      ::new (&_slots[pos]) T(std::move(value));
+      _control_byte(pos) = _tag(h);
+    }
+  }
+  _size = size;
+  _growth_left -= size;
+
+  _destroy(old_control, old_slots, old_groups);
+}
+
+template <class T, class H>
+void SwissHashTable<T, H>::_destroy(Group *control, Slot *slots,
+                                    std::size_t groups) {
+  for (std::size_t i = 0; i < groups * Group::width; ++i)
+    if (control[i / Group::width].bytes[i % Group::width] >= 0)
+      reinterpret_cast<T *>(&slots[i])->~T();
+  delete[] control;
+  delete[] slots;
+}
+
+#endif // GUARD_SWISS_HASH_TABLE_HPP__
@@ -0,0 +1,111 @@
+#include "concurrent_hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using CHT = ConcurrentHashTable<int>;
+
+TEST(ConcurrentHashTable, DefaultCtor) {
+  CHT h;
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_FALSE(h.contains(0));
+  EXPECT_FALSE(h.find(0));
+}
+
+TEST(ConcurrentHashTable, ListCtor) {
+  std::initializer_list<int> l = {1, 2, 3, 4, 5};
+  CHT h = l;
+  EXPECT_EQ(h.size(), 5_z);
+  for (auto i : l)
+    EXPECT_EQ(*h.find(i), i);
+  EXPECT_FALSE(h.contains(0));
+}
+
+TEST(ConcurrentHashTable, AddRemoveElements) {
+  CHT h(4);
+  for (int i = 0; i < 1000; ++i)
+    h.insert(i);
+  ASSERT_EQ(h.size(), 1000_z);
+  ASSERT_GE(h.bucket_count(), 1000_z);
+  ASSERT_THROW(h.insert(42), std::runtime_error);
+  ASSERT_EQ(h.size(), 1000_z);
+
+  for (int i = 0; i < 1000; i += 2)
+    h.erase(i);
+  h.erase(-1);
+  ASSERT_EQ(h.size(), 500_z);
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(h.contains(i), i % 2 == 1);
+}
+
+TEST(ConcurrentHashTable, Strings) {
+  ConcurrentHashTable<std::string> h = {"a", "b", "c"};
+  for (int i = 0; i < 100; ++i)
+    h.insert(std::to_string(i));
+  ASSERT_EQ(h.size(), 103_z);
+  ASSERT_EQ(*h.find("42"), "42");
+  h.erase("42");
+  ASSERT_FALSE(h.find("42"));
+}
+
+// Threads insert disjoint ranges while others look them up and erase part of
+// them, forcing many resizes to happen concurrently with other operations
+TEST(ConcurrentHashTable, Stress) {
+  constexpr int threads = 8, per_thread = 20000;
+  CHT h(16);
+  std::atomic<int> misses(0);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&h, &misses, t] {
+      int first = t * per_thread;
+      for (int i = first; i < first + per_thread; ++i) {
+        h.insert(i);
+        // Values of other threads may or may not be there yet
+        h.contains(i + per_thread);
+        if (!h.contains(i))
+          ++misses;
+      }
+      for (int i = first; i < first + per_thread; i += 2)
+        h.erase(i);
+    });
+  }
+  for (auto &w : workers)
+    w.join();
+
+  ASSERT_EQ(misses.load(), 0);
+  ASSERT_EQ(h.size(), std::size_t(threads * per_thread / 2));
+  for (int i = 0; i < threads * per_thread; ++i)
+    ASSERT_EQ(h.contains(i), i % 2 == 1);
+}
+
+// Concurrent insertions of the same values: each must succeed exactly once
+TEST(ConcurrentHashTable, ConcurrentDuplicates) {
+  constexpr int threads = 4, count = 5000;
+  CHT h;
+  std::atomic<int> inserted(0);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&h, &inserted] {
+      for (int i = 0; i < count; ++i) {
+        try {
+          h.insert(i);
+          ++inserted;
+        } catch (const std::runtime_error &) {
+        }
+      }
+    });
+  }
+  for (auto &w : workers)
+    w.join();
+
+  ASSERT_EQ(inserted.load(), count);
+  ASSERT_EQ(h.size(), std::size_t(count));
+}
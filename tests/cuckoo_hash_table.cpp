@@ -0,0 +1,114 @@
+#include "cuckoo_hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+
+using CH = CuckooHashTable<int>;
+
+TEST(CuckooHashTable, DefaultCtor) {
+  CH h;
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_FALSE(h.contains(0));
+}
+
+TEST(CuckooHashTable, ListCtor) {
+  std::initializer_list<int> l = {1, 2, 3, 4, 5};
+  CH h = l;
+  EXPECT_EQ(h.size(), 5_z);
+  for (auto i : l)
+    EXPECT_NO_THROW(h[i]);
+  EXPECT_THROW(h[0], std::out_of_range);
+}
+
+TEST(CuckooHashTable, CpyCtor) {
+  CH h = {1, 2, 3, 4, 5};
+  CH h2 = h;
+  EXPECT_EQ(h.size(), h2.size());
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_NO_THROW(h[i]);
+    EXPECT_NO_THROW(h2[i]);
+  }
+}
+
+TEST(CuckooHashTable, MoveCtor) {
+  CH h = {1, 2, 3, 4, 5};
+  CH h2 = std::move(h);
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_EQ(h2.size(), 5_z);
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_THROW(h[i], std::out_of_range);
+    EXPECT_NO_THROW(h2[i]);
+  }
+}
+
+TEST(CuckooHashTable, AddElements) {
+  CH h;
+  h.insert(0);
+  ASSERT_EQ(h.size(), 1_z);
+  ASSERT_NO_THROW(h[0]);
+  h.insert(10);
+  ASSERT_EQ(h.size(), 2_z);
+  ASSERT_NO_THROW(h[10]);
+  h.insert(42);
+  ASSERT_EQ(h.size(), 3_z);
+  ASSERT_NO_THROW(h[42]);
+  ASSERT_THROW(h.insert(42), std::runtime_error);
+  ASSERT_EQ(h.size(), 3_z);
+}
+
+TEST(CuckooHashTable, RemoveElements) {
+  CH h = {1, 2, 3, 4, 5};
+  h.erase(3);
+  EXPECT_EQ(h.size(), 4_z);
+  EXPECT_FALSE(h.contains(3));
+  h.erase(3);
+  EXPECT_EQ(h.size(), 4_z);
+  for (int i : {1, 2, 4, 5})
+    EXPECT_TRUE(h.contains(i));
+}
+
+TEST(CuckooHashTable, ManyElements) {
+  // Evictions and resizes keep every element reachable
+  CH h;
+  for (int i = 0; i < 100000; ++i)
+    h.insert(i * 3);
+  EXPECT_EQ(h.size(), 100000_z);
+  // The table fills up to 7/8 of its slots before growing
+  EXPECT_LE(h.bucket_count() * 4, 2 * 100000 * 8 / 7 + 4);
+  for (int i = 0; i < 300000; ++i)
+    ASSERT_EQ(h.contains(i), i % 3 == 0) << i;
+  for (int i = 0; i < 100000; i += 2)
+    h.erase(i * 3);
+  EXPECT_EQ(h.size(), 50000_z);
+  for (int i = 0; i < 100000; ++i)
+    ASSERT_EQ(h.contains(i * 3), i % 2 == 1) << i;
+}
+
+// Every value has the same hash
+struct SameHash {
+  std::size_t operator()(const int &) { return 7; }
+};
+
+TEST(CuckooHashTable, Collisions) {
+  // Two buckets of 4 slots hold at most 8 values with the same hash
+  CuckooHashTable<int, SameHash> h;
+  for (int i = 0; i < 8; ++i)
+    h.insert(i);
+  EXPECT_THROW(h.insert(8), std::runtime_error);
+  EXPECT_EQ(h.size(), 8_z);
+  for (int i = 0; i < 8; ++i)
+    EXPECT_TRUE(h.contains(i));
+  EXPECT_FALSE(h.contains(8));
+}
+
+TEST(CuckooHashTable, Strings) {
+  CuckooHashTable<std::string> h;
+  for (int i = 0; i < 1000; ++i)
+    h.insert("value " + std::to_string(i));
+  EXPECT_EQ(h.size(), 1000_z);
+  EXPECT_EQ(h["value 500"], "value 500");
+  EXPECT_FALSE(h.contains("value 1000"));
+}
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <memory>
+#include <string>
 #include <vcruntime.h>
 
 #include "dynamic_array.hpp"
@@ -97,4 +99,121 @@ TEST(DynamicArray, Sort) {
       ASSERT_EQ(r[j], d[i][j]);
     }
   }
-}
\ No newline at end of file
+}
+
+// Element without default constructor counting its live instances and copies
+struct Counted {
+  static int live, copies;
+  int value;
+  explicit Counted(int v) : value(v) { ++live; }
+  Counted(const Counted &c) : value(c.value) {
+    ++live;
+    ++copies;
+  }
+  Counted(Counted &&c) noexcept : value(c.value) { ++live; }
+  Counted &operator=(const Counted &) = default;
+  ~Counted() { --live; }
+};
+int Counted::live = 0;
+int Counted::copies = 0;
+
+TEST(DynamicArray, EmplaceBack) {
+  Counted::live = Counted::copies = 0;
+  {
+    DynamicArray<Counted> d;
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_EQ(d.emplace_back(i).value, i);
+      ASSERT_EQ(Counted::live, i + 1);
+    }
+    // Growth moves the elements
+    ASSERT_EQ(Counted::copies, 0);
+    d.pop();
+    ASSERT_EQ(Counted::live, 99);
+    for (int i = 0; i < 99; ++i)
+      ASSERT_EQ(d[i].value, i);
+  }
+  ASSERT_EQ(Counted::live, 0);
+}
+
+TEST(DynamicArray, PushBackMoveOnly) {
+  DynamicArray<std::unique_ptr<int>> d;
+  for (int i = 0; i < 20; ++i)
+    d.push_back(std::make_unique<int>(i));
+  DynamicArray<std::unique_ptr<int>> d2{std::move(d)};
+  ASSERT_EQ(d2.size(), 20_z);
+  for (int i = 0; i < 20; ++i)
+    ASSERT_EQ(*d2[i], i);
+}
+
+TEST(DynamicArray, PushBackOwnElement) {
+  DynamicArray<std::string> d = {"a"};
+  for (int i = 0; i < 10; ++i)
+    d.push_back(d[0]);
+  ASSERT_EQ(d.size(), 11_z);
+  for (const auto &s : d)
+    ASSERT_EQ(s, "a");
+}
+
+TEST(DynamicArray, Reserve) {
+  DA d;
+  d.reserve(50);
+  ASSERT_EQ(d.size(), 0_z);
+  ASSERT_EQ(d.capacity(), 50_z);
+  const int *data = d.begin();
+  for (int i = 0; i < 50; ++i)
+    d.push_back(i);
+  ASSERT_EQ(d.begin(), data);
+  d.reserve(10);
+  ASSERT_EQ(d.capacity(), 50_z);
+  for (int i = 0; i < 50; ++i)
+    ASSERT_EQ(d[i], i);
+}
+
+TEST(DynamicArray, Resize) {
+  DynamicArray<std::string> d = {"a", "b", "c"};
+  d.resize(5);
+  ASSERT_EQ(d.size(), 5_z);
+  ASSERT_EQ(d[2], "c");
+  ASSERT_EQ(d[4], "");
+  d.resize(1);
+  ASSERT_EQ(d.size(), 1_z);
+  ASSERT_EQ(d[0], "a");
+
+  // Removed elements are destroyed
+  auto shared = std::make_shared<int>(0);
+  DynamicArray<std::shared_ptr<int>> p;
+  for (int i = 0; i < 10; ++i)
+    p.push_back(shared);
+  p.resize(4);
+  ASSERT_EQ(shared.use_count(), 5);
+}
+
+TEST(DynamicArray, ShrinkToFit) {
+  DA d;
+  for (int i = 0; i < 100; ++i)
+    d.push_back(i);
+  d.resize(10);
+  d.shrink_to_fit();
+  ASSERT_EQ(d.capacity(), 10_z);
+  ASSERT_EQ(d, (DA{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  d.resize(0);
+  d.shrink_to_fit();
+  ASSERT_EQ(d.capacity(), 0_z);
+  d.push_back(1);
+  ASSERT_EQ(d, DA{1});
+
+  DynamicArray<std::string> s = {"a", "b"};
+  s.reserve(100);
+  s.shrink_to_fit();
+  ASSERT_EQ(s.capacity(), 2_z);
+  ASSERT_EQ(s[1], "b");
+}
+
+TEST(DynamicArray, ConstIterator) {
+  static_assert(std::is_same<DA::const_iterator, const int *>::value,
+                "elements must not be modifiable through a const_iterator");
+  const DA d = {0, 1, 2};
+  int i = 0;
+  for (DA::const_iterator it = d.begin(); it != d.end(); ++it)
+    ASSERT_EQ(*it, i++);
+}
@@ -0,0 +1,87 @@
+#include "frozen_hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using FHT = FrozenHashTable<int>;
+
+TEST(FrozenHashTable, DefaultCtor) {
+  FHT h;
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_FALSE(h.contains(0));
+  EXPECT_THROW(h[0], std::out_of_range);
+}
+
+TEST(FrozenHashTable, ListCtor) {
+  std::initializer_list<int> l = {1, 2, 3, 4, 5};
+  FHT h = l;
+  EXPECT_EQ(h.size(), 5_z);
+  for (auto i : l)
+    EXPECT_EQ(h[i], i);
+  EXPECT_FALSE(h.contains(0));
+  EXPECT_FALSE(h.contains(6));
+  EXPECT_THROW(h[0], std::out_of_range);
+}
+
+TEST(FrozenHashTable, Duplicates) {
+  EXPECT_THROW(FHT({1, 2, 3, 2}), std::runtime_error);
+}
+
+TEST(FrozenHashTable, FromDynamicArray) {
+  DynamicArray<int> array;
+  for (int i = 0; i < 10000; ++i)
+    array.push_back(i * 7);
+  FHT h = array;
+  ASSERT_EQ(h.size(), 10000_z);
+  for (int i = 0; i < 70000; ++i)
+    ASSERT_EQ(h.contains(i), i % 7 == 0);
+}
+
+TEST(FrozenHashTable, FromHashTable) {
+  HashTable<std::string> table;
+  for (int i = 0; i < 1000; ++i)
+    table.insert(std::to_string(i));
+  FrozenHashTable<std::string> h = table;
+  ASSERT_EQ(h.size(), 1000_z);
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(*h.find(std::to_string(i)), std::to_string(i));
+  EXPECT_FALSE(h.contains("1000"));
+
+  // Heterogeneous lookups
+  EXPECT_TRUE(h.contains(std::string_view("42")));
+  EXPECT_TRUE(h.contains("999"));
+  EXPECT_FALSE(h.find("abc"));
+}
+
+TEST(FrozenHashTable, CpyCtor) {
+  FrozenHashTable<std::string> h = {"a", "b", "c"};
+  auto h2 = h;
+  EXPECT_EQ(h2.size(), 3_z);
+  EXPECT_TRUE(h2.contains("a"));
+  EXPECT_TRUE(h.contains("a"));
+}
+
+TEST(FrozenHashTable, MoveCtor) {
+  FrozenHashTable<std::string> h = {"a", "b", "c"};
+  auto h2 = std::move(h);
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_FALSE(h.contains("a"));
+  EXPECT_EQ(h2.size(), 3_z);
+  EXPECT_TRUE(h2.contains("c"));
+}
+
+TEST(FrozenHashTable, LargeTable) {
+  // Quick to build with the spare slots, the last buckets of a full array
+  // need as many seeds as there are slots
+  DynamicArray<int> array;
+  for (int i = 0; i < (1 << 18); ++i)
+    array.push_back(i * 3);
+  FHT h = array;
+  ASSERT_EQ(h.size(), 1_z << 18);
+  for (int i = 0; i < (3 << 18); ++i)
+    ASSERT_EQ(h.contains(i), i % 3 == 0);
+}
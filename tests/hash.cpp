@@ -0,0 +1,126 @@
+#include "details/hash.hpp"
+#include "details/seeded_hash.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <bitset>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST(Hash, StringTypes) {
+  const char *c_string = "some string";
+  const wchar_t *w_string = L"some string";
+  EXPECT_EQ(hash<std::string>()(c_string), hash<const char *>()(c_string));
+  EXPECT_EQ(hash<std::string>()(c_string), hash<std::string_view>()(c_string));
+  EXPECT_EQ(hash<std::wstring>()(w_string), hash<const wchar_t *>()(w_string));
+  EXPECT_NE(hash<std::string>()("a"), hash<std::string>()("b"));
+}
+
+TEST(Hash, Lengths) {
+  // Prefixes of the same string must all hash differently, in particular
+  // around the 4, 16 and 48 bytes boundaries of the algorithm
+  std::string s(200, 'a');
+  std::set<std::size_t> hashes;
+  for (std::size_t i = 0; i <= s.size(); ++i)
+    hashes.insert(hash<std::string_view>()(std::string_view(s.data(), i)));
+  EXPECT_EQ(hashes.size(), s.size() + 1);
+}
+
+TEST(Hash, Avalanche) {
+  // Flipping any single bit of the input must flip about half of the bits of
+  // the output
+  for (std::size_t len : {3_z, 8_z, 16_z, 33_z, 100_z}) {
+    std::string s;
+    for (std::size_t i = 0; i < len; ++i)
+      s.push_back(static_cast<char>('a' + i * 7 % 26));
+    std::uint64_t reference = details::hash_bytes(s.data(), s.size());
+
+    std::size_t flipped = 0;
+    for (std::size_t bit = 0; bit < len * 8; ++bit) {
+      s[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+      flipped += std::bitset<64>(details::hash_bytes(s.data(), s.size()) ^
+                                 reference)
+                     .count();
+      s[bit / 8] ^= static_cast<char>(1 << (bit % 8));
+    }
+    double average = static_cast<double>(flipped) / (len * 8);
+    EXPECT_GT(average, 28.) << "length " << len;
+    EXPECT_LT(average, 36.) << "length " << len;
+  }
+}
+
+TEST(Hash, Distribution) {
+  // Similar keys spread uniformly over buckets selected by the low bits of
+  // the hash: chi-squared test over 4096 buckets
+  const std::size_t buckets = 4096, keys = 100000;
+  std::vector<std::size_t> counts(buckets, 0);
+  for (std::size_t i = 0; i < keys; ++i)
+    ++counts[hash<std::string>()("key" + std::to_string(i)) & (buckets - 1)];
+
+  double expected = static_cast<double>(keys) / buckets;
+  double chi2 = 0;
+  for (auto c : counts)
+    chi2 += (c - expected) * (c - expected) / expected;
+  // Mean buckets - 1, standard deviation about 90
+  EXPECT_LT(chi2, 4600.);
+  EXPECT_GT(chi2, 3600.);
+}
+
+constexpr std::string_view hash_samples[] = {
+    "", "a", "abc", "abcd", "some string", "exactly sixteen!",
+    "a string longer than sixteen bytes",
+    "a string long enough to go through the three lanes of the algorithm"};
+constexpr std::size_t constexpr_hash(std::size_t i) {
+  return hash<std::string_view>()(hash_samples[i]);
+}
+constexpr std::size_t hash_expected[] = {
+    constexpr_hash(0), constexpr_hash(1), constexpr_hash(2), constexpr_hash(3),
+    constexpr_hash(4), constexpr_hash(5), constexpr_hash(6), constexpr_hash(7)};
+
+TEST(Hash, Constexpr) {
+  // Hashes computed by the compiler match the ones computed at runtime
+  for (std::size_t i = 0; i < std::size(hash_samples); ++i)
+    EXPECT_EQ(hash_expected[i],
+              hash<std::string>()(std::string(hash_samples[i])));
+
+  constexpr std::size_t wide = hash<std::wstring_view>()(L"wide string");
+  EXPECT_EQ(wide, hash<std::wstring>()(std::wstring(L"wide string")));
+  constexpr std::size_t c_string = hash<const char *>()("c string");
+  EXPECT_EQ(c_string, hash<std::string>()("c string"));
+  static_assert(hash<int>()(42) == 42, "constexpr integer hash");
+}
+
+TEST(Hash, SipHash) {
+  // Reference vectors of SipHash-2-4: key 00 01 .. 0f, messages 00 01 .. n-1
+  const std::uint64_t k0 = 0x0706050403020100ull, k1 = 0x0f0e0d0c0b0a0908ull;
+  auto sip_hash_2_4 = &details::sip_hash<2, 4>;
+  unsigned char message[15];
+  for (unsigned char i = 0; i < 15; ++i)
+    message[i] = i;
+  EXPECT_EQ(sip_hash_2_4(message, 0, k0, k1), 0x726fdb47dd0e0e31ull);
+  EXPECT_EQ(sip_hash_2_4(message, 8, k0, k1), 0x93f5f5799a932462ull);
+  EXPECT_EQ(sip_hash_2_4(message, 15, k0, k1), 0xa129ca6149be45e5ull);
+}
+
+TEST(Hash, Seeded) {
+  // Functors built with the same keys agree, others do not
+  seeded_hash<std::string> a(1, 2), b(1, 2), c(1, 3);
+  EXPECT_EQ(a("some string"), b("some string"));
+  EXPECT_NE(a("some string"), c("some string"));
+  EXPECT_EQ(a(std::string("abc")), a(std::string_view("abc")));
+  EXPECT_EQ(seeded_hash<int>()(42), seeded_hash<int>()(42));
+  EXPECT_NE(seeded_hash<long>::random()(42), seeded_hash<long>::random()(42));
+  // Both halves of the key change from one functor to the next
+  auto r0 = seeded_hash<long>::random(), r1 = seeded_hash<long>::random();
+  EXPECT_NE(r0.k0, r1.k0);
+  EXPECT_NE(r0.k1, r1.k1);
+  EXPECT_NE(r0.k0, r0.k1);
+
+  std::set<std::size_t> hashes;
+  for (int i = 0; i < 1000; ++i)
+    hashes.insert(seeded_hash<int>()(i));
+  EXPECT_EQ(hashes.size(), 1000_z);
+}
@@ -0,0 +1,140 @@
+#include "hash_map.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using HM = HashMap<int, std::string>;
+
+TEST(HashMap, DefaultCtor) {
+  HM h;
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_FALSE(h.contains(0));
+}
+
+TEST(HashMap, ListCtor) {
+  HM h = {{1, "one"}, {2, "two"}, {3, "three"}};
+  EXPECT_EQ(h.size(), 3_z);
+  EXPECT_EQ(h.at(1), "one");
+  EXPECT_EQ(h.at(2), "two");
+  EXPECT_EQ(h.at(3), "three");
+  EXPECT_THROW(h.at(0), std::out_of_range);
+}
+
+TEST(HashMap, CpyCtor) {
+  HM h = {{1, "one"}, {2, "two"}};
+  HM h2 = h;
+  EXPECT_EQ(h2.size(), 2_z);
+  EXPECT_EQ(h2.at(1), "one");
+  h2.at(1) = "uno";
+  EXPECT_EQ(h.at(1), "one");
+}
+
+TEST(HashMap, MoveCtor) {
+  HM h = {{1, "one"}, {2, "two"}};
+  HM h2 = std::move(h);
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_EQ(h2.size(), 2_z);
+  EXPECT_FALSE(h.contains(1));
+  EXPECT_EQ(h2.at(2), "two");
+}
+
+TEST(HashMap, Insert) {
+  HM h;
+  h.insert({1, "one"});
+  ASSERT_EQ(h.size(), 1_z);
+  ASSERT_THROW(h.insert({1, "uno"}), std::runtime_error);
+  ASSERT_EQ(h.at(1), "one");
+}
+
+TEST(HashMap, TryEmplace) {
+  HM h;
+  auto r = h.try_emplace(1, 3, 'a');
+  ASSERT_TRUE(r.second);
+  ASSERT_EQ(*r.first, "aaa");
+  r = h.try_emplace(1, "b");
+  ASSERT_FALSE(r.second);
+  ASSERT_EQ(*r.first, "aaa");
+  ASSERT_EQ(h.size(), 1_z);
+}
+
+TEST(HashMap, InsertOrAssign) {
+  HM h;
+  auto r = h.insert_or_assign(1, "one");
+  ASSERT_TRUE(r.second);
+  ASSERT_EQ(*r.first, "one");
+  r = h.insert_or_assign(1, "uno");
+  ASSERT_FALSE(r.second);
+  ASSERT_EQ(*r.first, "uno");
+  ASSERT_EQ(h.at(1), "uno");
+  ASSERT_EQ(h.size(), 1_z);
+}
+
+TEST(HashMap, Subscript) {
+  HashMap<std::string, int> h;
+  ASSERT_EQ(h["a"], 0);
+  ASSERT_EQ(h.size(), 1_z);
+  h["a"] += 2;
+  h["b"] = 3;
+  ASSERT_EQ(h.at("a"), 2);
+  ASSERT_EQ(h.at("b"), 3);
+  ASSERT_EQ(h.size(), 2_z);
+}
+
+TEST(HashMap, Erase) {
+  HM h;
+  for (int i = 0; i < 100; ++i)
+    h[i] = std::to_string(i);
+  ASSERT_EQ(h.size(), 100_z);
+  for (int i = 0; i < 100; i += 2)
+    h.erase(i);
+  h.erase(1000);
+  ASSERT_EQ(h.size(), 50_z);
+  for (int i = 0; i < 100; ++i) {
+    auto v = h.find(i);
+    ASSERT_EQ(static_cast<bool>(v), i % 2 == 1);
+    if (v) {
+      ASSERT_EQ(*v, std::to_string(i));
+    }
+  }
+}
+
+TEST(HashMap, HeterogeneousLookup) {
+  HashMap<std::string, int> h = {{"abc", 1}, {"def", 2}};
+  EXPECT_EQ(*h.find(std::string_view("abc")), 1);
+  EXPECT_TRUE(h.contains("def"));
+  h.erase(std::string_view("abc"));
+  EXPECT_FALSE(h.contains("abc"));
+  EXPECT_EQ(h.size(), 1_z);
+}
+
+// Counts the copies of the values
+struct CopyCounter {
+  static int copies;
+  CopyCounter() = default;
+  CopyCounter(const CopyCounter &) { ++copies; }
+  CopyCounter(CopyCounter &&) = default;
+  CopyCounter &operator=(const CopyCounter &) = default;
+};
+int CopyCounter::copies = 0;
+
+TEST(HashMap, ResizeWithoutCopies) {
+  HashMap<int, CopyCounter> h;
+  for (int i = 0; i < 1000; ++i)
+    h.try_emplace(i);
+  EXPECT_GT(h.bucket_count(), 2_z);
+  EXPECT_EQ(CopyCounter::copies, 0);
+
+  // Values that cannot be copied are supported as well
+  HashMap<int, std::unique_ptr<int>> pointers;
+  for (int i = 0; i < 1000; ++i)
+    pointers.try_emplace(i, std::make_unique<int>(i));
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(*pointers.at(i), i);
+  pointers.erase(42);
+  EXPECT_FALSE(pointers.contains(42));
+}
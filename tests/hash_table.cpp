@@ -4,6 +4,9 @@
 #include "gtest/gtest.h"
 
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <iterator>
 #include <vector>
 
 using HT = HashTable<int>;
@@ -74,4 +77,394 @@ TEST(HashTable, RemoveElements) {
   ASSERT_EQ(h.size(), 1_z);
   h.erase(4);
   ASSERT_EQ(h.size(), 0_z);
-}
\ No newline at end of file
+}
+
+TEST(HashTable, MixHash) {
+  // Strided keys must not end up in the same few buckets once masked
+  std::vector<bool> used(64, false);
+  std::size_t buckets = 0;
+  for (std::size_t i = 0; i < 64; ++i) {
+    std::size_t pos = details::mix_hash(hash<std::size_t>()(i * 64)) & 63;
+    buckets += !used[pos];
+    used[pos] = true;
+  }
+  EXPECT_GT(buckets, 32_z);
+}
+
+TEST(HashTable, LoadFactor) {
+  HT h;
+  EXPECT_EQ(h.max_load_factor(), 1.f);
+  for (int i = 0; i < 100; ++i) {
+    h.insert(i);
+    EXPECT_LE(h.load_factor(), h.max_load_factor());
+  }
+
+  h.max_load_factor(0.25f);
+  EXPECT_LE(h.load_factor(), 0.25f);
+  EXPECT_GE(h.bucket_count(), 400_z);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(h.contains(i));
+
+  EXPECT_THROW(h.max_load_factor(0), std::invalid_argument);
+}
+
+TEST(HashTable, Reserve) {
+  HT h;
+  h.reserve(1000);
+  std::size_t buckets = h.bucket_count();
+  EXPECT_GE(buckets, 1000_z);
+  for (int i = 0; i < 1000; ++i)
+    h.insert(i);
+  EXPECT_EQ(h.bucket_count(), buckets);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_TRUE(h.contains(i));
+}
+
+TEST(HashTable, Rehash) {
+  HT h = {1, 2, 3, 4, 5};
+  h.rehash(100);
+  EXPECT_EQ(h.bucket_count(), 128_z);
+  for (int i = 1; i <= 5; ++i)
+    EXPECT_TRUE(h.contains(i));
+
+  // Never shrink below what the elements require
+  h.rehash(0);
+  EXPECT_EQ(h.bucket_count(), 8_z);
+  for (int i = 1; i <= 5; ++i)
+    EXPECT_TRUE(h.contains(i));
+}
+
+TEST(HashTable, IncrementalRehash) {
+  HT h;
+  h.incremental_rehash(1);
+  bool migrated = false;
+  for (int i = 0; i < 1000; ++i) {
+    h.insert(i);
+    migrated |= h.rehashing();
+    // Elements must be found whether their bucket has been migrated or not
+    for (int j = 0; j <= i; j += 7)
+      ASSERT_TRUE(h.contains(j));
+  }
+  EXPECT_TRUE(migrated);
+  EXPECT_EQ(h.size(), 1000_z);
+
+  for (int i = 0; i < 1000; i += 2)
+    h.erase(i);
+  EXPECT_EQ(h.size(), 500_z);
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(h.contains(i), i % 2 == 1);
+
+  HT copy = h;
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(copy.contains(i), i % 2 == 1);
+
+  h.incremental_rehash(0);
+  EXPECT_FALSE(h.rehashing());
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(h.contains(i), i % 2 == 1);
+}
+
+TEST(HashTable, HeterogeneousLookup) {
+  const char *c_string = "abc";
+  std::string_view view = "abc";
+  EXPECT_EQ(hash<std::string>()("abc"), hash<const char *>()(c_string));
+  EXPECT_EQ(hash<std::string>()("abc"), hash<std::string_view>()(view));
+
+  HashTable<std::string> h = {"abc", "def", "ghi"};
+  EXPECT_TRUE(h.contains(view));
+  EXPECT_TRUE(h.contains(c_string));
+  EXPECT_FALSE(h.contains(std::string_view("ab")));
+  EXPECT_EQ(*h.find(view), "abc");
+  EXPECT_EQ(*h.find("def"), "def");
+
+  h.erase(std::string_view("def"));
+  h.erase("ghi");
+  EXPECT_EQ(h.size(), 1_z);
+  EXPECT_FALSE(h.contains("def"));
+}
+
+// Counts the calls to the hash functor
+struct CountingHash {
+  static std::size_t calls;
+  std::size_t operator()(const std::string &s) {
+    ++calls;
+    return hash<std::string>()(s);
+  }
+};
+std::size_t CountingHash::calls = 0;
+
+TEST(HashTable, CachedHash) {
+  HashTable<std::string, CountingHash, true> h;
+  for (int i = 0; i < 100; ++i)
+    h.insert(std::to_string(i));
+  // One hash per insertion, none during resizes
+  EXPECT_EQ(CountingHash::calls, 100_z);
+  EXPECT_GT(h.bucket_count(), 2_z);
+
+  auto copy = h;
+  EXPECT_EQ(CountingHash::calls, 100_z);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(copy.contains(std::to_string(i)));
+
+  CountingHash::calls = 0;
+  HashTable<std::string, CountingHash, false> uncached;
+  for (int i = 0; i < 100; ++i)
+    uncached.insert(std::to_string(i));
+  EXPECT_GT(CountingHash::calls, 100_z);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_TRUE(uncached.contains(std::to_string(i)));
+}
+
+TEST(HashTable, BatchedOperations) {
+  HT h;
+  std::vector<int> values;
+  for (int i = 0; i < 1000; ++i)
+    values.push_back(i * 2);
+  h.insert_many(values.begin(), values.end());
+  ASSERT_EQ(h.size(), 1000_z);
+
+  std::vector<int> keys;
+  for (int i = 0; i < 100; ++i)
+    keys.push_back(i);
+
+  std::vector<bool> found;
+  h.contains_many(keys.begin(), keys.end(), std::back_inserter(found));
+  ASSERT_EQ(found.size(), keys.size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(found[i], i % 2 == 0);
+
+  std::vector<HT::Maybe<int>> results;
+  h.find_many(keys.begin(), keys.end(), std::back_inserter(results));
+  ASSERT_EQ(results.size(), keys.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(static_cast<bool>(results[i]), i % 2 == 0);
+    if (results[i]) {
+      EXPECT_EQ(*results[i], i);
+    }
+  }
+
+  const HT &c = h;
+  std::vector<HT::Maybe<const int>> const_results;
+  c.find_many(keys.begin(), keys.end(), std::back_inserter(const_results));
+  ASSERT_EQ(const_results.size(), keys.size());
+  EXPECT_EQ(*const_results[42], 42);
+
+  // The values preceding a duplicate are inserted
+  std::vector<int> more = {1, 3, 4, 5};
+  EXPECT_THROW(h.insert_many(more.begin(), more.end()), std::runtime_error);
+  EXPECT_EQ(h.size(), 1002_z);
+  EXPECT_TRUE(h.contains(3));
+  EXPECT_FALSE(h.contains(5));
+}
+
+TEST(HashTable, BatchedHeterogeneousLookup) {
+  HashTable<std::string> h = {"abc", "def"};
+  std::vector<std::string_view> keys = {"abc", "xyz", "def"};
+  std::vector<bool> found;
+  h.contains_many(keys.begin(), keys.end(), std::back_inserter(found));
+  EXPECT_EQ(found, std::vector<bool>({true, false, true}));
+}
+
+TEST(HashTable, StableAddresses) {
+  HashTable<std::string> h = {"first"};
+  const std::string *address = &*h.find("first");
+  // Growing relinks the nodes, the elements stay where they are
+  for (int i = 0; i < 1000; ++i)
+    h.insert(std::to_string(i));
+  h.incremental_rehash(4);
+  for (int i = 1000; i < 3000; ++i)
+    h.insert(std::to_string(i));
+  EXPECT_EQ(&*h.find("first"), address);
+  h.rehash(4096);
+  EXPECT_EQ(&*h.find("first"), address);
+}
+
+// Move-only value counting its constructions
+struct Tracked {
+  static int constructions;
+  explicit Tracked(int k) : key(k) { ++constructions; }
+  Tracked(int a, int b) : key(a + b) { ++constructions; }
+  Tracked(Tracked &&t) : key(t.key) {}
+  Tracked(const Tracked &) = delete;
+  bool operator==(const Tracked &t) const { return key == t.key; }
+  int key;
+};
+int Tracked::constructions = 0;
+
+struct TrackedHash {
+  std::size_t operator()(const Tracked &t) { return hash<int>()(t.key); }
+};
+
+TEST(HashTable, MoveAndEmplace) {
+  HashTable<Tracked, TrackedHash> h;
+  h.insert(Tracked(1));
+  h.emplace(2);
+  h.emplace(1, 2);
+  EXPECT_EQ(Tracked::constructions, 3);
+  EXPECT_EQ(h.size(), 3_z);
+  EXPECT_TRUE(h.contains(Tracked(3)));
+  EXPECT_THROW(h.emplace(1), std::runtime_error);
+  EXPECT_THROW(h.insert(Tracked(2)), std::runtime_error);
+  EXPECT_EQ(h.size(), 3_z);
+
+  HashTable<std::string> strings;
+  std::string s(100, 'a');
+  const char *data = s.data();
+  strings.insert(std::move(s));
+  EXPECT_EQ(strings.find(std::string(100, 'a'))->data(), data);
+}
+
+TEST(HashTable, CopyWithoutHashing) {
+  HashTable<std::string, CountingHash, false> h;
+  h.incremental_rehash(1);
+  for (int i = 0; i <= 100; ++i)
+    h.insert(std::to_string(i));
+  ASSERT_TRUE(h.rehashing());
+
+  CountingHash::calls = 0;
+  auto copy = h;
+  EXPECT_EQ(CountingHash::calls, 0_z);
+  EXPECT_EQ(copy.size(), h.size());
+  EXPECT_EQ(copy.bucket_count(), h.bucket_count());
+  EXPECT_TRUE(copy.rehashing());
+  for (int i = 0; i <= 100; ++i)
+    EXPECT_TRUE(copy.contains(std::to_string(i)));
+}
+
+TEST(HashTable, TryInsert) {
+  HashTable<std::string> h;
+  auto inserted = h.try_insert("abc");
+  ASSERT_TRUE(inserted.second);
+  ASSERT_EQ(*inserted.first, "abc");
+
+  auto found = h.try_insert("abc");
+  EXPECT_FALSE(found.second);
+  EXPECT_EQ(&*found.first, &*inserted.first);
+  EXPECT_EQ(h.size(), 1_z);
+
+  // A duplicate passed by rvalue is left untouched
+  std::string value = "abc";
+  EXPECT_FALSE(h.try_insert(std::move(value)).second);
+  EXPECT_EQ(value, "abc");
+  EXPECT_TRUE(h.try_insert(std::string("def")).second);
+
+  auto emplaced = h.try_emplace(3, 'x');
+  EXPECT_TRUE(emplaced.second);
+  EXPECT_EQ(*emplaced.first, "xxx");
+  EXPECT_FALSE(h.try_emplace("xxx").second);
+  EXPECT_EQ(h.size(), 3_z);
+}
+
+// Every value has the same hash
+struct ConstantHash {
+  std::size_t operator()(const int &) { return 0; }
+};
+
+TEST(HashTable, Statistics) {
+  HT h;
+  auto empty = h.statistics();
+  EXPECT_EQ(empty.size, 0_z);
+  EXPECT_EQ(empty.longest_chain, 0_z);
+  EXPECT_EQ(empty.chain_lengths, std::vector<std::size_t>({2}));
+
+  for (int i = 0; i < 1000; ++i)
+    h.insert(i);
+  auto stats = h.statistics();
+  EXPECT_EQ(stats.size, 1000_z);
+  EXPECT_EQ(stats.bucket_count, h.bucket_count());
+  EXPECT_FLOAT_EQ(stats.load_factor, h.load_factor());
+  EXPECT_EQ(stats.chain_lengths.size(), stats.longest_chain + 1);
+  std::size_t buckets = 0, elements = 0;
+  for (std::size_t i = 0; i < stats.chain_lengths.size(); ++i) {
+    buckets += stats.chain_lengths[i];
+    elements += i * stats.chain_lengths[i];
+  }
+  EXPECT_EQ(buckets, h.bucket_count());
+  EXPECT_EQ(elements, 1000_z);
+
+  // A degenerate hash function shows up as a long chain
+  HashTable<int, ConstantHash> bad;
+  for (int i = 0; i < 100; ++i)
+    bad.insert(i * 4);
+  EXPECT_EQ(bad.statistics().longest_chain, 100_z);
+
+#ifdef HASH_TABLE_STATISTICS
+  EXPECT_EQ(stats.rehash_count, 9_z);
+  EXPECT_GT(stats.rehash_time.count(), 0);
+#else
+  EXPECT_EQ(stats.rehash_count, 0_z);
+#endif
+}
+
+// Value counting its comparisons
+struct Compared {
+  static int comparisons;
+  Compared(int k) : key(k) {}
+  bool operator==(const Compared &c) const {
+    ++comparisons;
+    return key == c.key;
+  }
+  int key;
+};
+int Compared::comparisons = 0;
+
+struct ComparedHash {
+  std::size_t operator()(const Compared &c) { return hash<int>()(c.key); }
+};
+
+TEST(HashTable, BloomFilter) {
+  HashTable<Compared, ComparedHash> h;
+  EXPECT_EQ(h.bloom_filter(), 0_z);
+  h.insert(0);
+  h.bloom_filter(10);
+  EXPECT_EQ(h.bloom_filter(), 10_z);
+  EXPECT_TRUE(h.contains(0));
+
+  // No element is missed across resizes and incremental migrations
+  for (int i = 1; i < 5000; ++i)
+    h.insert(i);
+  h.incremental_rehash(4);
+  for (int i = 5000; i < 10000; ++i)
+    h.insert(i);
+  EXPECT_TRUE(h.rehashing());
+  for (int i = 0; i < 10000; ++i)
+    ASSERT_TRUE(h.contains(i)) << i;
+
+  // Most absent keys are rejected without being compared
+  Compared::comparisons = 0;
+  for (int i = 10000; i < 20000; ++i)
+    EXPECT_FALSE(h.contains(i));
+  EXPECT_LT(Compared::comparisons, 500);
+
+  // Without the filter, every candidate of the bucket is compared
+  h.bloom_filter(0);
+  Compared::comparisons = 0;
+  for (int i = 10000; i < 20000; ++i)
+    EXPECT_FALSE(h.contains(i));
+  EXPECT_GT(Compared::comparisons, 1000);
+
+  // Copies keep the filter
+  h.bloom_filter(8);
+  h.erase(3);
+  HashTable<Compared, ComparedHash> copy(h);
+  EXPECT_EQ(copy.bloom_filter(), 8_z);
+  EXPECT_FALSE(copy.contains(3));
+  EXPECT_TRUE(copy.contains(4));
+}
+
+TEST(HashTable, SeededHash) {
+  // Every table draws its own keys, copies keep the keys of the original
+  HashTable<std::string, seeded_hash<std::string>> a = {"abc", "def"}, b;
+  EXPECT_NE(a.hash_function()("abc"), b.hash_function()("abc"));
+  HashTable<std::string, seeded_hash<std::string>> copy(a);
+  EXPECT_EQ(copy.hash_function()("abc"), a.hash_function()("abc"));
+  EXPECT_TRUE(copy.contains("abc"));
+  EXPECT_TRUE(a.contains(std::string_view("def")));
+
+  HashTable<int, seeded_hash<int>> h;
+  for (int i = 0; i < 10000; ++i)
+    h.insert(i * 1024);
+  for (int i = 0; i < 10000; ++i)
+    ASSERT_TRUE(h.contains(i * 1024));
+  EXPECT_LT(h.statistics().longest_chain, 12_z);
+}
@@ -0,0 +1,40 @@
+// Built without HASH_TABLE_STATISTICS, unlike the other tests: the macro has
+// to be the same in every translation unit of a program
+#include "hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#ifdef HASH_TABLE_STATISTICS
+#error "this test must be built without HASH_TABLE_STATISTICS"
+#endif
+
+namespace {
+// Expected layouts of the nodes, the counters must not add anything to them
+struct PlainNode {
+  int value;
+  void *next;
+};
+struct CachedNode {
+  int value;
+  std::size_t hash;
+  void *next;
+};
+} // namespace
+
+static_assert(sizeof(details::HashNode<int, false>) == sizeof(PlainNode),
+              "unexpected field in the nodes");
+static_assert(sizeof(details::HashNode<int, true>) == sizeof(CachedNode),
+              "unexpected field in the nodes");
+
+TEST(HashTableNoStatistics, NoRehashCounters) {
+  HashTable<int> h;
+  for (int i = 0; i < 1000; ++i)
+    h.insert(i);
+
+  auto stats = h.statistics();
+  EXPECT_EQ(stats.size, 1000_z);
+  EXPECT_EQ(stats.bucket_count, h.bucket_count());
+  EXPECT_EQ(stats.rehash_count, 0_z);
+  EXPECT_EQ(stats.rehash_time.count(), 0);
+}
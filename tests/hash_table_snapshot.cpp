@@ -0,0 +1,107 @@
+#include "hash_table_snapshot.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+// Path of a temporary file removed at the end of the test
+struct TemporaryFile {
+  explicit TemporaryFile(const std::string &name)
+      : path((std::filesystem::temp_directory_path() / name).string()) {}
+  ~TemporaryFile() { std::remove(path.c_str()); }
+  std::string path;
+};
+
+TEST(HashTableSnapshot, WriteAndOpen) {
+  TemporaryFile file("hash_table_snapshot_strings");
+  {
+    // The snapshot outlives its source
+    HashTable<std::string> table;
+    for (int i = 0; i < 10000; ++i)
+      table.insert("key" + std::to_string(i));
+    table.insert("");
+    HashTableSnapshot<>::write(table, file.path);
+  }
+
+  HashTableSnapshot<> snapshot(file.path);
+  ASSERT_EQ(snapshot.size(), 10001_z);
+  for (int i = 0; i < 10000; ++i)
+    ASSERT_TRUE(snapshot.contains("key" + std::to_string(i)));
+  EXPECT_TRUE(snapshot.contains(""));
+  EXPECT_FALSE(snapshot.contains("key10000"));
+  EXPECT_FALSE(snapshot.contains("key"));
+  EXPECT_EQ(*snapshot.find("key42"), "key42");
+  EXPECT_FALSE(snapshot.find("missing"));
+
+  HashTableSnapshot<> moved = std::move(snapshot);
+  EXPECT_TRUE(moved.contains("key9999"));
+}
+
+TEST(HashTableSnapshot, EmptyAndWideStrings) {
+  TemporaryFile empty_file("hash_table_snapshot_empty");
+  HashTableSnapshot<>::write(HashTable<std::string>(), empty_file.path);
+  HashTableSnapshot<> empty(empty_file.path);
+  EXPECT_EQ(empty.size(), 0_z);
+  EXPECT_FALSE(empty.contains("a"));
+
+  TemporaryFile wide_file("hash_table_snapshot_wide");
+  HashTableSnapshot<wchar_t>::write(HashTable<std::wstring>{L"a", L"bc"},
+                                    wide_file.path);
+  HashTableSnapshot<wchar_t> wide(wide_file.path);
+  EXPECT_TRUE(wide.contains(L"bc"));
+  EXPECT_FALSE(wide.contains(L"b"));
+  // A snapshot of other characters is rejected
+  EXPECT_THROW(HashTableSnapshot<>{wide_file.path}, std::runtime_error);
+}
+
+TEST(HashTableSnapshot, Replace) {
+  TemporaryFile file("hash_table_snapshot_replaced");
+  HashTableSnapshot<>::write(HashTable<std::string>{"old"}, file.path);
+#if !defined(_WIN32)
+  // The old file stays readable while mapped. Windows cannot replace a
+  // mapped file.
+  HashTableSnapshot<> old_snapshot(file.path);
+#endif
+
+  HashTableSnapshot<>::write(HashTable<std::string>{"new", "newer"},
+                             file.path);
+  HashTableSnapshot<> new_snapshot(file.path);
+  EXPECT_EQ(new_snapshot.size(), 2_z);
+  EXPECT_TRUE(new_snapshot.contains("newer"));
+  EXPECT_FALSE(new_snapshot.contains("old"));
+#if !defined(_WIN32)
+  EXPECT_EQ(old_snapshot.size(), 1_z);
+  EXPECT_TRUE(old_snapshot.contains("old"));
+#endif
+
+  // The rename fails over a directory, the temporary file is removed
+  TemporaryFile directory("hash_table_snapshot_directory");
+  std::filesystem::create_directory(directory.path);
+  EXPECT_THROW(HashTableSnapshot<>::write(HashTable<std::string>{"a"},
+                                          directory.path),
+               std::runtime_error);
+  EXPECT_TRUE(std::filesystem::is_directory(directory.path));
+
+  // No temporary file is left behind
+  auto parent = std::filesystem::path(file.path).parent_path();
+  for (const auto &entry : std::filesystem::directory_iterator(parent)) {
+    std::string name = entry.path().filename().string();
+    if (name.rfind("hash_table_snapshot_", 0) == 0) {
+      EXPECT_EQ(name.find(".tmp"), std::string::npos) << name;
+    }
+  }
+}
+
+TEST(HashTableSnapshot, InvalidFiles) {
+  EXPECT_THROW(HashTableSnapshot<>("/nonexistent/snapshot"),
+               std::runtime_error);
+
+  TemporaryFile file("hash_table_snapshot_invalid");
+  std::ofstream(file.path) << "not a snapshot, but long enough for a header";
+  EXPECT_THROW(HashTableSnapshot<>{file.path}, std::runtime_error);
+}
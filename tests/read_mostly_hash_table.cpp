@@ -0,0 +1,118 @@
+#include "read_mostly_hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using RMHT = ReadMostlyHashTable<int>;
+
+TEST(ReadMostlyHashTable, DefaultCtor) {
+  RMHT h;
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_FALSE(h.contains(0));
+}
+
+TEST(ReadMostlyHashTable, Operations) {
+  RMHT h = {1, 2, 3};
+  EXPECT_EQ(h.size(), 3_z);
+  EXPECT_THROW(h.insert(2), std::runtime_error);
+  h.insert(4);
+  EXPECT_EQ(*h.find(4), 4);
+  EXPECT_FALSE(h.find(5));
+  h.erase(1);
+  h.erase(1);
+  EXPECT_FALSE(h.contains(1));
+  EXPECT_EQ(h.size(), 3_z);
+
+  h.update([](RMHT::table_type &t) {
+    for (int i = 10; i < 20; ++i)
+      t.insert(i);
+  });
+  EXPECT_EQ(h.size(), 13_z);
+
+  // A failed update publishes nothing
+  auto failing = [](RMHT::table_type &t) {
+    t.insert(100);
+    t.insert(10);
+  };
+  EXPECT_THROW(h.update(failing), std::runtime_error);
+  EXPECT_FALSE(h.contains(100));
+  EXPECT_EQ(h.size(), 13_z);
+}
+
+TEST(ReadMostlyHashTable, HeterogeneousLookup) {
+  ReadMostlyHashTable<std::string> h = {"abc", "def"};
+  EXPECT_TRUE(h.contains(std::string_view("abc")));
+  EXPECT_FALSE(h.contains("ghi"));
+  EXPECT_EQ(*h.find("def"), "def");
+}
+
+TEST(ReadMostlyHashTable, SnapshotIsolation) {
+  RMHT h = {1};
+  std::atomic<bool> published{false};
+  std::thread writer;
+  {
+    auto s = h.snapshot();
+    writer = std::thread([&] {
+      h.insert(2);
+      published = true;
+    });
+    // The writer publishes its version, then waits for the snapshot
+    while (!h.contains(2))
+      std::this_thread::yield();
+    EXPECT_FALSE(s->contains(2));
+    EXPECT_EQ(s->size(), 1_z);
+    EXPECT_FALSE(published);
+  }
+  writer.join();
+  EXPECT_TRUE(published);
+  EXPECT_EQ(h.size(), 2_z);
+}
+
+TEST(ReadMostlyHashTable, ConcurrentReaders) {
+  RMHT h;
+  h.update([](RMHT::table_type &t) {
+    for (int i = 0; i < 100; ++i)
+      t.insert(i);
+  });
+
+  std::atomic<bool> done{false};
+  std::atomic<int> errors{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; ++r)
+    readers.emplace_back([&] {
+      while (!done) {
+        auto s = h.snapshot();
+        // Values never modified are always there, and the pairs inserted and
+        // erased together are seen together
+        for (int i = 0; i < 100; ++i)
+          errors += !s->contains(i);
+        for (int i = 1000; i < 1010; ++i)
+          errors += s->contains(2 * i) != s->contains(2 * i + 1);
+      }
+    });
+
+  for (int round = 0; round < 100; ++round) {
+    int i = 1000 + round % 10;
+    h.update([i](RMHT::table_type &t) {
+      if (t.contains(2 * i)) {
+        t.erase(2 * i);
+        t.erase(2 * i + 1);
+      } else {
+        t.insert(2 * i);
+        t.insert(2 * i + 1);
+      }
+    });
+  }
+  done = true;
+  for (std::thread &t : readers)
+    t.join();
+  EXPECT_EQ(errors, 0);
+  EXPECT_EQ(h.size(), 100_z);
+}
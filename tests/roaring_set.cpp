@@ -0,0 +1,152 @@
+#include "roaring_set.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using RS = RoaringSet<std::uint32_t>;
+
+template <class T> std::vector<T> values_of(const RoaringSet<T> &s) {
+  std::vector<T> values;
+  s.for_each([&values](T v) { values.push_back(v); });
+  return values;
+}
+
+TEST(RoaringSet, DefaultCtor) {
+  RS s;
+  EXPECT_EQ(s.size(), 0_z);
+  EXPECT_FALSE(s.contains(0));
+}
+
+TEST(RoaringSet, Operations) {
+  RS s = {1, 70000, 5, 1u << 31};
+  EXPECT_EQ(s.size(), 4_z);
+  EXPECT_TRUE(s.contains(70000));
+  EXPECT_FALSE(s.contains(70001));
+  EXPECT_THROW(s.insert(5), std::runtime_error);
+  EXPECT_FALSE(s.try_insert(5));
+  EXPECT_TRUE(s.try_insert(6));
+  s.erase(1);
+  s.erase(2);
+  EXPECT_EQ(values_of(s), std::vector<std::uint32_t>({5, 6, 70000, 1u << 31}));
+}
+
+TEST(RoaringSet, SignedValues) {
+  RoaringSet<int> s = {-5, 3, std::numeric_limits<int>::min(), 0,
+                       std::numeric_limits<int>::max()};
+  EXPECT_TRUE(s.contains(-5));
+  EXPECT_FALSE(s.contains(5));
+  EXPECT_EQ(values_of(s),
+            std::vector<int>({std::numeric_limits<int>::min(), -5, 0, 3,
+                              std::numeric_limits<int>::max()}));
+}
+
+TEST(RoaringSet, Containers) {
+  // A chunk goes through the array, bitmap and run forms, and back
+  RS s;
+  std::set<std::uint32_t> expected;
+  for (std::uint32_t i = 0; i < 60000; i += 3) {
+    s.insert(i);
+    expected.insert(i);
+  }
+  for (std::uint32_t i = 0; i < 60000; i += 6) {
+    s.erase(i);
+    expected.erase(i);
+  }
+  EXPECT_EQ(s.size(), expected.size());
+  std::vector<std::uint32_t> sorted(expected.begin(), expected.end());
+  EXPECT_EQ(values_of(s), sorted);
+  for (std::uint32_t i = 0; i < 60000; ++i)
+    ASSERT_EQ(s.contains(i), expected.count(i) == 1) << i;
+
+  // Back to an array once small enough
+  for (std::uint32_t i = 3; i < 60000; i += 6)
+    if (i > 3000)
+      s.erase(i);
+  EXPECT_EQ(s.size(), 500_z);
+  EXPECT_TRUE(s.contains(2997));
+  EXPECT_FALSE(s.contains(3003));
+}
+
+TEST(RoaringSet, Runs) {
+  RS s;
+  for (std::uint32_t i = 100; i < 50000; ++i)
+    s.insert(i);
+  for (std::uint32_t i = 200000; i < 200010; ++i)
+    s.insert(i);
+  std::size_t before = s.memory_usage();
+  std::vector<std::uint32_t> values = values_of(s);
+
+  s.optimize();
+  EXPECT_LT(s.memory_usage(), before / 20);
+  EXPECT_EQ(values_of(s), values);
+  EXPECT_TRUE(s.contains(100));
+  EXPECT_TRUE(s.contains(49999));
+  EXPECT_FALSE(s.contains(99));
+  EXPECT_FALSE(s.contains(50000));
+  EXPECT_TRUE(s.contains(200005));
+
+  // Modifying a run container expands it
+  s.erase(1000);
+  s.insert(60000);
+  EXPECT_FALSE(s.contains(1000));
+  EXPECT_TRUE(s.contains(60000));
+  EXPECT_EQ(s.size(), values.size());
+}
+
+TEST(RoaringSet, SetAlgebra) {
+  // Every pair of forms: sparse arrays, dense bitmaps and runs
+  RS a, b;
+  std::set<std::uint32_t> sa, sb;
+  for (std::uint32_t i = 0; i < 300000; i += 7) {
+    a.insert(i);
+    sa.insert(i);
+  }
+  for (std::uint32_t i = 0; i < 300000; i += 2) {
+    if (i < 65536 * 2 || (i / 65536) % 2 == 0) {
+      b.insert(i);
+      sb.insert(i);
+    }
+  }
+  for (std::uint32_t i = 250000; i < 260000; ++i) {
+    b.try_insert(i);
+    sb.insert(i);
+  }
+  b.optimize();
+
+  std::vector<std::uint32_t> united, common;
+  std::set_union(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                 std::back_inserter(united));
+  std::set_intersection(sa.begin(), sa.end(), sb.begin(), sb.end(),
+                        std::back_inserter(common));
+
+  RS u = a | b;
+  EXPECT_EQ(u.size(), united.size());
+  EXPECT_EQ(values_of(u), united);
+  RS i = a & b;
+  EXPECT_EQ(i.size(), common.size());
+  EXPECT_EQ(values_of(i), common);
+  EXPECT_EQ(values_of(b & a), common);
+
+  RS empty;
+  EXPECT_EQ((a & empty).size(), 0_z);
+  EXPECT_EQ((empty | a).size(), a.size());
+}
+
+TEST(RoaringSet, MemoryUsage) {
+  // Pseudo-random values with the density of 100M values over 32 bits take
+  // about 2 bytes each, against several pointers per element in a HashTable
+  RS s;
+  std::uint32_t x = 12345;
+  for (int i = 0; i < 1000000; ++i) {
+    x = x * 1664525u + 1013904223u;
+    s.try_insert(x >> 6);
+  }
+  EXPECT_GT(s.size(), 990000_z);
+  EXPECT_LT(s.memory_usage(), s.size() * 5 / 2);
+}
@@ -0,0 +1,124 @@
+#include "robin_hood_hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+
+using RH = RobinHoodHashTable<int>;
+
+TEST(RobinHoodHashTable, DefaultCtor) {
+  RH h;
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_FALSE(h.contains(0));
+}
+
+TEST(RobinHoodHashTable, ListCtor) {
+  std::initializer_list<int> l = {1, 2, 3, 4, 5};
+  RH h = l;
+  EXPECT_EQ(h.size(), 5_z);
+  for (auto i : l)
+    EXPECT_NO_THROW(h[i]);
+  EXPECT_THROW(h[0], std::out_of_range);
+}
+
+TEST(RobinHoodHashTable, CpyCtor) {
+  RH h = {1, 2, 3, 4, 5};
+  RH h2 = h;
+  EXPECT_EQ(h.size(), h2.size());
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_NO_THROW(h[i]);
+    EXPECT_NO_THROW(h2[i]);
+  }
+}
+
+TEST(RobinHoodHashTable, MoveCtor) {
+  RH h = {1, 2, 3, 4, 5};
+  RH h2 = std::move(h);
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_EQ(h2.size(), 5_z);
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_THROW(h[i], std::out_of_range);
+    EXPECT_NO_THROW(h2[i]);
+  }
+}
+
+TEST(RobinHoodHashTable, AddElements) {
+  RH h;
+  h.insert(0);
+  ASSERT_EQ(h.size(), 1_z);
+  ASSERT_NO_THROW(h[0]);
+  h.insert(10);
+  ASSERT_EQ(h.size(), 2_z);
+  ASSERT_NO_THROW(h[10]);
+  h.insert(42);
+  ASSERT_EQ(h.size(), 3_z);
+  ASSERT_NO_THROW(h[42]);
+  ASSERT_THROW(h.insert(42), std::runtime_error);
+  ASSERT_EQ(h.size(), 3_z);
+}
+
+TEST(RobinHoodHashTable, RemoveElements) {
+  RH h = {1, 2, 3, 4, 5};
+  h.erase(42);
+  ASSERT_EQ(h.size(), 5_z);
+  h.erase(1);
+  ASSERT_EQ(h.size(), 4_z);
+  h.erase(5);
+  ASSERT_EQ(h.size(), 3_z);
+  h.erase(3);
+  ASSERT_EQ(h.size(), 2_z);
+  h.erase(1);
+  ASSERT_EQ(h.size(), 2_z);
+  h.erase(2);
+  ASSERT_EQ(h.size(), 1_z);
+  h.erase(4);
+  ASSERT_EQ(h.size(), 0_z);
+}
+
+// Only 4 different hashes, every probe sequence collides
+struct CollidingHash {
+  std::size_t operator()(const int &i) { return i & 3; }
+};
+
+TEST(RobinHoodHashTable, Collisions) {
+  RobinHoodHashTable<int, CollidingHash> h;
+  for (int i = 0; i < 64; ++i)
+    h.insert(i * 1024);
+  ASSERT_EQ(h.size(), 64_z);
+  for (int i = 0; i < 64; ++i)
+    ASSERT_TRUE(h.contains(i * 1024));
+  ASSERT_FALSE(h.contains(1));
+
+  // Backward shifting must keep every remaining element reachable
+  for (int i = 0; i < 64; i += 2)
+    h.erase(i * 1024);
+  ASSERT_EQ(h.size(), 32_z);
+  for (int i = 0; i < 64; ++i)
+    ASSERT_EQ(h.contains(i * 1024), i % 2 == 1);
+}
+
+TEST(RobinHoodHashTable, Strings) {
+  RobinHoodHashTable<std::string> h = {"a", "b", "c"};
+  for (int i = 0; i < 100; ++i)
+    h.insert(std::to_string(i));
+  ASSERT_EQ(h.size(), 103_z);
+  ASSERT_EQ(*h.find("42"), "42");
+  h.erase("42");
+  ASSERT_FALSE(h.find("42"));
+  ASSERT_TRUE(h.contains("a"));
+}
+
+TEST(RobinHoodHashTable, DuplicateDoesNotGrow) {
+  // 7 elements fill the initial 8 slots up to the maximum load, the next
+  // insertion grows the table and moves the elements
+  RH h = {0, 1, 2, 3, 4, 5, 6};
+  const int *before = &*h.find(3);
+  EXPECT_THROW(h.insert(3), std::runtime_error);
+  EXPECT_EQ(&*h.find(3), before);
+  h.insert(7);
+  EXPECT_EQ(h.size(), 8_z);
+  for (int i = 0; i < 8; ++i)
+    EXPECT_TRUE(h.contains(i));
+}
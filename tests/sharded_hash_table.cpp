@@ -0,0 +1,127 @@
+#include "sharded_hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using SHT = ShardedHashTable<int>;
+
+TEST(ShardedHashTable, DefaultCtor) {
+  SHT h;
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_EQ(h.shard_count(), 16_z);
+  EXPECT_EQ(SHT(5).shard_count(), 8_z);
+  EXPECT_EQ(SHT(1).shard_count(), 1_z);
+}
+
+TEST(ShardedHashTable, ListCtor) {
+  SHT h = {1, 2, 3};
+  EXPECT_EQ(h.size(), 3_z);
+  EXPECT_TRUE(h.contains(2));
+  EXPECT_FALSE(h.contains(4));
+  EXPECT_THROW(SHT({1, 1}), std::runtime_error);
+}
+
+TEST(ShardedHashTable, Operations) {
+  SHT h(4);
+  for (int i = 0; i < 1000; ++i)
+    h.insert(i);
+  EXPECT_EQ(h.size(), 1000_z);
+  EXPECT_THROW(h.insert(10), std::runtime_error);
+
+  // Every shard gets a share of the values and grows on its own
+  std::size_t total = 0;
+  for (std::size_t s = 0; s < h.shard_count(); ++s) {
+    EXPECT_GT(h.shard(s).size(), 100_z);
+    EXPECT_LT(h.shard(s).bucket_count(), 1024_z);
+    total += h.shard(s).size();
+  }
+  EXPECT_EQ(total, 1000_z);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_TRUE(h.shard(h.shard_of(i)).contains(i));
+
+  h.erase(10);
+  EXPECT_FALSE(h.contains(10));
+  EXPECT_FALSE(h.find(10));
+  EXPECT_EQ(*h.find(11), 11);
+  EXPECT_EQ(h[12], 12);
+  EXPECT_THROW(h[10], std::out_of_range);
+  EXPECT_EQ(h.size(), 999_z);
+
+  int sum = 0;
+  h.for_each([&sum](int i) { sum += i; });
+  EXPECT_EQ(sum, 999 * 1000 / 2 - 10);
+}
+
+TEST(ShardedHashTable, BulkBuild) {
+  std::vector<int> values;
+  for (int i = 0; i < 100000; ++i)
+    values.push_back(i * 7);
+
+  for (unsigned threads : {0u, 1u, 3u, 8u}) {
+    SHT h;
+    h.insert(-1);
+    h.bulk_build(values.begin(), values.end(), threads);
+    EXPECT_EQ(h.size(), values.size() + 1);
+    for (int v : values)
+      ASSERT_TRUE(h.contains(v)) << v;
+    EXPECT_TRUE(h.contains(-1));
+    EXPECT_FALSE(h.contains(1));
+  }
+
+  SHT h;
+  h.bulk_build(values.begin(), values.begin());
+  EXPECT_EQ(h.size(), 0_z);
+  h.bulk_build(values.begin(), values.end());
+  EXPECT_EQ(h.size(), values.size());
+}
+
+TEST(ShardedHashTable, BulkBuildDuplicates) {
+  std::vector<int> values = {1, 2, 3, 4, 5, 6, 7, 8, 9, 3};
+  SHT h;
+  EXPECT_THROW(h.bulk_build(values.begin(), values.end(), 4),
+               std::runtime_error);
+
+  // Values already in the table are duplicates as well
+  SHT g = {42};
+  std::vector<int> others = {40, 41, 42, 43};
+  EXPECT_THROW(g.bulk_build(others.begin(), others.end(), 2),
+               std::runtime_error);
+}
+
+TEST(ShardedHashTable, HeterogeneousLookup) {
+  ShardedHashTable<std::string> h;
+  std::vector<std::string> words = {"alpha", "beta", "gamma", "delta"};
+  h.bulk_build(words.begin(), words.end(), 2);
+  EXPECT_TRUE(h.contains(std::string_view("gamma")));
+  EXPECT_TRUE(h.contains("delta"));
+  EXPECT_FALSE(h.contains("epsilon"));
+  EXPECT_EQ(*h.find(std::string_view("beta")), "beta");
+}
+
+TEST(ShardedHashTable, SeededHash) {
+  // The shards hash with the keys of the table, which the hashes computed by
+  // bulk_build rely on
+  typedef ShardedHashTable<std::string, seeded_hash<std::string>> Seeded;
+  std::vector<std::string> values;
+  for (int i = 0; i < 10000; ++i)
+    values.push_back(std::to_string(i));
+
+  Seeded h(8);
+  h.bulk_build(values.begin(), values.end(), 4);
+  EXPECT_EQ(h.size(), values.size());
+  for (const auto &v : values) {
+    ASSERT_TRUE(h.contains(v)) << v;
+    ASSERT_TRUE(h.shard(h.shard_of(v)).contains(v)) << v;
+  }
+  for (std::size_t i = 0; i < h.shard_count(); ++i) {
+    EXPECT_GT(h.shard(i).size(), 0_z);
+    EXPECT_EQ(h.shard(i).hash_function().k0, h.shard(0).hash_function().k0);
+  }
+  EXPECT_NE(Seeded().shard(0).hash_function().k0,
+            h.shard(0).hash_function().k0);
+}
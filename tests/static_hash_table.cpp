@@ -0,0 +1,44 @@
+#include "static_hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Built entirely at compile time
+constexpr StaticHashTable<int, 5> numbers = {1, 2, 3, 42, -7};
+constexpr StaticHashTable<std::string_view, 4> keywords = {
+    "if", "else", "while", "a rather long keyword, to hash more than 48 bytes"};
+
+static_assert(numbers.contains(42), "constexpr lookup");
+static_assert(!numbers.contains(4), "constexpr lookup");
+static_assert(numbers[-7] == -7, "constexpr access");
+static_assert(keywords.contains("while"), "constexpr string lookup");
+static_assert(!keywords.contains("for"), "constexpr string lookup");
+
+TEST(StaticHashTable, Lookups) {
+  EXPECT_EQ(numbers.size(), 5_z);
+  for (int i : {1, 2, 3, 42, -7})
+    EXPECT_TRUE(numbers.contains(i));
+  EXPECT_FALSE(numbers.contains(0));
+  EXPECT_EQ(*numbers.find(3), 3);
+  EXPECT_FALSE(numbers.find(4));
+  EXPECT_THROW(numbers[4], std::out_of_range);
+
+  // Hashed at runtime, the keys must match the compile time layout
+  std::string key = "else";
+  EXPECT_TRUE(keywords.contains(key));
+  EXPECT_TRUE(
+      keywords.contains("a rather long keyword, to hash more than 48 bytes"));
+  EXPECT_FALSE(keywords.contains("els"));
+  EXPECT_EQ(keywords.values()[0], "if");
+}
+
+TEST(StaticHashTable, RuntimeConstruction) {
+  StaticHashTable<std::string_view, 3> h = {"a", "b", "c"};
+  EXPECT_TRUE(h.contains("b"));
+  EXPECT_THROW((StaticHashTable<int, 3>{1, 2, 1}), std::runtime_error);
+  EXPECT_THROW((StaticHashTable<int, 3>{1, 2}), std::invalid_argument);
+}
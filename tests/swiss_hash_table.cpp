@@ -0,0 +1,141 @@
+#include "swiss_hash_table.hpp"
+
+#include "utility.hpp"
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+
+using SW = SwissHashTable<int>;
+
+TEST(SwissHashTable, DefaultCtor) {
+  SW h;
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_FALSE(h.contains(0));
+}
+
+TEST(SwissHashTable, ListCtor) {
+  std::initializer_list<int> l = {1, 2, 3, 4, 5};
+  SW h = l;
+  EXPECT_EQ(h.size(), 5_z);
+  for (auto i : l)
+    EXPECT_NO_THROW(h[i]);
+  EXPECT_THROW(h[0], std::out_of_range);
+}
+
+TEST(SwissHashTable, CpyCtor) {
+  SW h = {1, 2, 3, 4, 5};
+  SW h2 = h;
+  EXPECT_EQ(h.size(), h2.size());
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_NO_THROW(h[i]);
+    EXPECT_NO_THROW(h2[i]);
+  }
+}
+
+TEST(SwissHashTable, MoveCtor) {
+  SW h = {1, 2, 3, 4, 5};
+  SW h2 = std::move(h);
+  EXPECT_EQ(h.size(), 0_z);
+  EXPECT_EQ(h2.size(), 5_z);
+  for (int i = 1; i <= 5; ++i) {
+    EXPECT_THROW(h[i], std::out_of_range);
+    EXPECT_NO_THROW(h2[i]);
+  }
+}
+
+TEST(SwissHashTable, AddElements) {
+  SW h;
+  h.insert(0);
+  ASSERT_EQ(h.size(), 1_z);
+  ASSERT_NO_THROW(h[0]);
+  h.insert(10);
+  ASSERT_EQ(h.size(), 2_z);
+  ASSERT_NO_THROW(h[10]);
+  h.insert(42);
+  ASSERT_EQ(h.size(), 3_z);
+  ASSERT_NO_THROW(h[42]);
+  ASSERT_THROW(h.insert(42), std::runtime_error);
+  ASSERT_EQ(h.size(), 3_z);
+}
+
+TEST(SwissHashTable, RemoveElements) {
+  SW h = {1, 2, 3, 4, 5};
+  h.erase(42);
+  ASSERT_EQ(h.size(), 5_z);
+  h.erase(1);
+  ASSERT_EQ(h.size(), 4_z);
+  h.erase(5);
+  ASSERT_EQ(h.size(), 3_z);
+  h.erase(3);
+  ASSERT_EQ(h.size(), 2_z);
+  h.erase(1);
+  ASSERT_EQ(h.size(), 2_z);
+  h.erase(2);
+  ASSERT_EQ(h.size(), 1_z);
+  h.erase(4);
+  ASSERT_EQ(h.size(), 0_z);
+}
+
+TEST(SwissHashTable, Collisions) {
+  // Values sharing their low bits must still be spread over the groups
+  SW h;
+  for (int i = 0; i < 64; ++i)
+    h.insert(i * 1024);
+  ASSERT_EQ(h.size(), 64_z);
+  for (int i = 0; i < 64; ++i)
+    ASSERT_TRUE(h.contains(i * 1024));
+  ASSERT_FALSE(h.contains(1));
+
+  // Deleted slots must keep every remaining element reachable
+  for (int i = 0; i < 64; i += 2)
+    h.erase(i * 1024);
+  ASSERT_EQ(h.size(), 32_z);
+  for (int i = 0; i < 64; ++i)
+    ASSERT_EQ(h.contains(i * 1024), i % 2 == 1);
+}
+
+TEST(SwissHashTable, Churn) {
+  // Repeated insertions and deletions fill the table with deleted slots which
+  // must be reclaimed without breaking lookups
+  SW h;
+  for (int i = 0; i < 1000; ++i) {
+    h.insert(i);
+    if (i >= 10)
+      h.erase(i - 10);
+  }
+  ASSERT_EQ(h.size(), 10_z);
+  for (int i = 0; i < 1000; ++i)
+    ASSERT_EQ(h.contains(i), i >= 990);
+}
+
+TEST(SwissHashTable, Strings) {
+  SwissHashTable<std::string> h = {"a", "b", "c"};
+  for (int i = 0; i < 100; ++i)
+    h.insert(std::to_string(i));
+  ASSERT_EQ(h.size(), 103_z);
+  ASSERT_EQ(*h.find("42"), "42");
+  h.erase("42");
+  ASSERT_FALSE(h.find("42"));
+  ASSERT_TRUE(h.contains("a"));
+}
+
+TEST(SwissHashTable, ScalarMatch) {
+  // Compare the portable matcher with the one in use on control bytes mixing
+  // tags, empty and deleted slots
+  details::ControlGroup g;
+  for (int round = 0; round < 100; ++round) {
+    for (unsigned i = 0; i < details::ControlGroup::width; ++i) {
+      unsigned r = (round * 37 + i * 11) % 10;
+      g.bytes[i] = r == 0   ? details::ControlGroup::empty
+                   : r == 1 ? details::ControlGroup::deleted
+                            : static_cast<signed char>(r % 4);
+    }
+    EXPECT_EQ(g.match_free_scalar(), g.match_free());
+    for (signed char tag : {0, 1, 2, 3, 4})
+      EXPECT_EQ(g.match_scalar(tag), g.match(tag));
+    EXPECT_EQ(g.match_scalar(details::ControlGroup::empty), g.match_empty());
+  }
+  g.bytes[3] = 5;
+  EXPECT_EQ(g.match_scalar(5), 1u << 3);
+}